@@ -0,0 +1,151 @@
+#pragma once
+#include "Types.hpp"
+#include "Assert.hpp"
+#include <new>
+#include <utility>
+
+namespace cgba
+{
+    //Bump allocator over a fixed buffer. Nothing is freed individually, the arena is reset back to a marker instead,
+    //destructors are not run on reset so it's meant for trivially destructible data
+    class Arena
+    {
+    public:
+        using Marker = u32;
+
+    private:
+        u8* buffer;
+        u32 size;
+        u32 top = 0;
+
+    public:
+        Arena(void* _buffer, u32 _size);
+
+        //Returns nullptr when the arena is out of space
+        void* Allocate(u32 bytes, u32 alignment = alignof(u32));
+
+        //Returns nullptr when the arena is out of space
+        template<class Ty, class... Args>
+        Ty* New(Args&&... args)
+        {
+            void* memory = Allocate(sizeof(Ty), alignof(Ty));
+            CGBA_ASSERT(memory, "Arena out of space");
+            if(!memory)
+                return nullptr;
+
+            return new(memory) Ty{ std::forward<Args>(args)... };
+        }
+
+        Marker GetMarker() const { return top; }
+        void Reset(Marker marker);
+        void Reset() { Reset(0); }
+
+        u32 GetUsed() const { return top; }
+        u32 GetSize() const { return size; }
+        WordBool Contains(const void* pointer) const;
+    };
+
+    //Resets the arena to where it was on construction, scenes keep one alive for as long as their data is used
+    class ScopedArenaReset
+    {
+        Arena& arena;
+        Arena::Marker marker;
+
+    public:
+        explicit ScopedArenaReset(Arena& _arena) :
+            arena{ _arena },
+            marker{ _arena.GetMarker() }
+        {
+
+        }
+
+        ScopedArenaReset(const ScopedArenaReset&) = delete;
+        ScopedArenaReset& operator=(const ScopedArenaReset&) = delete;
+
+        ~ScopedArenaReset()
+        {
+            arena.Reset(marker);
+        }
+    };
+
+    //Fixed size slots taken from an arena, freed slots are linked through their own storage
+    template<class Ty>
+    class Pool
+    {
+        union Slot
+        {
+            Slot* next;
+            alignas(Ty) u8 storage[sizeof(Ty)];
+        };
+
+        Slot* slots;
+        Slot* freeList;
+        u32 capacity;
+        u32 count = 0;
+
+    public:
+        static constexpr u32 slotSize = sizeof(Slot);
+        static constexpr u32 slotAlignment = alignof(Slot);
+
+        Pool(Arena& arena, u32 _capacity) :
+            Pool(arena.Allocate(slotSize * _capacity, slotAlignment), _capacity)
+        {
+
+        }
+
+        //storage must hold capacity slots of slotSize bytes, aligned to slotAlignment
+        Pool(void* storage, u32 _capacity) :
+            slots{ static_cast<Slot*>(storage) },
+            freeList{ slots },
+            capacity{ _capacity }
+        {
+            CGBA_ASSERT(slots, "Arena out of space");
+            for(u32 i = 0; i + 1 < capacity; i++)
+                slots[i].next = &slots[i + 1];
+
+            if(capacity > 0)
+                slots[capacity - 1].next = nullptr;
+        }
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        //Returns nullptr when every slot is in use
+        template<class... Args>
+        Ty* New(Args&&... args)
+        {
+            if(!freeList)
+                return nullptr;
+
+            Slot* slot = freeList;
+            freeList = slot->next;
+            count++;
+            return new(slot->storage) Ty{ std::forward<Args>(args)... };
+        }
+
+        void Delete(Ty* object)
+        {
+            Slot* slot = reinterpret_cast<Slot*>(object);
+            CGBA_ASSERT(slot >= slots && slot < slots + capacity, "Object doesn't belong to this pool");
+
+            object->~Ty();
+            slot->next = freeList;
+            freeList = slot;
+            count--;
+        }
+
+        u32 GetCount() const { return count; }
+        u32 GetCapacity() const { return capacity; }
+        WordBool IsFull() const { return freeList == nullptr; }
+    };
+
+    //Arenas over statically placed buffers, the sizes leave IWRAM room for the stack and the butano runtime
+    struct MemoryArenas
+    {
+        static constexpr u32 iwramArenaSize = 8 * 1024;
+        static constexpr u32 ewramArenaSize = 128 * 1024;
+
+        static Arena& Iwram();
+        static Arena& Ewram();
+    };
+}
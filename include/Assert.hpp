@@ -0,0 +1,50 @@
+#pragma once
+#include <type_traits>
+
+//How much checking CGBA_ASSERT does, pass -DCGBA_ASSERT_LEVEL=<level> in USERFLAGS to pick one:
+//  0: nothing is checked, the condition isn't even evaluated
+//  1: only constant evaluation is checked, a failed assert there is a compile error and no code is generated at runtime
+//  2: runtime checks too, a failure calls the assert handler
+//Builds defining NDEBUG default to 1, others to 2
+#ifndef CGBA_ASSERT_LEVEL
+    #ifdef NDEBUG
+        #define CGBA_ASSERT_LEVEL 1
+    #else
+        #define CGBA_ASSERT_LEVEL 2
+    #endif
+#endif
+
+namespace cgba
+{
+    using AssertHandler = void(*)(const char* condition, const char* message, const char* file, int line);
+
+    //The default handler logs to the mGBA debug console and stops, returns the handler that was replaced
+    AssertHandler SetAssertHandler(AssertHandler handler);
+
+    [[noreturn]] void AssertFailed(const char* condition, const char* message, const char* file, int line);
+
+    //Not constexpr on purpose, reaching it during constant evaluation is what makes the compile error
+    inline void ConstantAssertFailed(const char*) {}
+}
+
+//The optional message has to be a string literal
+#define CGBA_ASSERT(condition, ...) CGBA_ASSERT_IMPL(condition, "" __VA_ARGS__)
+
+#if CGBA_ASSERT_LEVEL == 0
+    #define CGBA_ASSERT_IMPL(condition, message) ((void)0)
+#elif CGBA_ASSERT_LEVEL == 1
+    #define CGBA_ASSERT_IMPL(condition, message) \
+        do { if(std::is_constant_evaluated() && !(condition)) ::cgba::ConstantAssertFailed(message); } while(false)
+#else
+    #define CGBA_ASSERT_IMPL(condition, message) \
+        do \
+        { \
+            if(!(condition)) [[unlikely]] \
+            { \
+                if(std::is_constant_evaluated()) \
+                    ::cgba::ConstantAssertFailed(message); \
+                else \
+                    ::cgba::AssertFailed(#condition, message, __FILE__, __LINE__); \
+            } \
+        } while(false)
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+#include "Types.hpp"
+#include "Compression.hpp"
+#include "Timer.hpp"
+#include "VRAMFormats.hpp"
+#include <array>
+#include <optional>
+
+namespace cgba
+{
+    //Streams assets into VRAM and palette RAM over several frames.
+    //Update spends at most a cycle budget decompressing into a staging buffer while the frame runs,
+    //CommitVBlank then copies finished data to its destination with DMA, up to a byte budget per VBlank.
+    //Jobs complete in the order they were queued
+    class AssetLoader
+    {
+    public:
+        static constexpr u32 maxJobs = 32;
+
+    private:
+        enum class JobType : u32
+        {
+            Copy,
+            Decompress
+        };
+
+        struct Job
+        {
+            JobType type;
+            const void* source;
+            volatile void* destination;
+            u32 size;
+            u32 copied;
+        };
+
+        std::array<Job, maxJobs> jobs;
+        u32 firstJob = 0;
+        u32 jobCount = 0;
+
+        u16* stagingBuffer;
+        u32 stagingSize;
+        std::optional<Decompressor> decompressor;
+
+        u32 cycleBudget;
+        u32 vblankByteBudget;
+        CycleCounter<> counter;
+
+    public:
+        //The staging buffer must be able to hold the largest decompressed asset, EWRAM is a good fit for it
+        AssetLoader(u16* _stagingBuffer, u32 _stagingSize, u32 _cycleBudget, u32 _vblankByteBudget = 8 * 1024);
+
+        //Both return false without queuing anything when the queue is full, empty assets are done without being queued
+        WordBool QueueCopy(const void* source, volatile void* destination, u32 size);
+        WordBool QueueDecompress(const void* source, volatile void* destination);
+
+        template<PaletteMode Mode, std::size_t Count>
+        WordBool QueueCopy(const std::array<CharacterTileTemplate<Mode, false>, Count>& tiles, CharacterBlockViewTemplate<Mode> view, u32 firstTile = 0)
+        {
+            return QueueCopy(tiles.data(), &view[firstTile], sizeof(tiles));
+        }
+
+        template<PaletteMode Mode>
+        WordBool QueueDecompress(const void* source, CharacterBlockViewTemplate<Mode> view, u32 firstTile = 0)
+        {
+            return QueueDecompress(source, &view[firstTile]);
+        }
+
+        template<PaletteMode Mode, std::size_t Count>
+        WordBool QueueCopy(const std::array<RGB15, Count>& colors, PaletteViewTemplate<Mode> view, u32 firstIndex = 0)
+        {
+            return QueueCopy(colors.data(), &view[firstIndex], sizeof(colors));
+        }
+
+        //Uses the timers of CycleCounter<> while running
+        void Update();
+        void CommitVBlank();
+
+        WordBool IsIdle() const { return jobCount == 0; }
+        u32 GetPendingJobCount() const { return jobCount; }
+
+        void SetCycleBudget(u32 cycles) { cycleBudget = cycles; }
+        void SetVBlankByteBudget(u32 bytes) { vblankByteBudget = bytes; }
+
+    private:
+        WordBool Queue(const Job& job);
+        Job& JobAt(u32 index) { return jobs[(firstJob + index) % maxJobs]; }
+        WordBool IsReady(const Job& job) const;
+    };
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include "Types.hpp"
+#include "MemoryRegion.hpp"
+#include "Math.hpp"
+#include "PackedRegister.hpp"
+#include "Assert.hpp"
+
+namespace cgba
+{
+    enum class BlendLayer : u32
+    {
+        Background0 = 0,
+        Background1 = 1,
+        Background2 = 2,
+        Background3 = 3,
+        Objects = 4,
+        Backdrop = 5
+    };
+
+    enum class BlendEffect : u32
+    {
+        None = 0,
+
+        //First targets are mixed with the second targets below them using the BLDALPHA weights
+        Alpha = 1,
+
+        //First targets move towards white or black by the BLDY weight
+        Brighten = 2,
+        Darken = 3
+    };
+
+    template<bool Volatile>
+    struct BlendControlRegisterTemplate
+    {
+        using First_Target = u16PackedRegisterData<u32, 6, 0>;
+        using Effect = u16PackedRegisterData<BlendEffect, 2, 6>;
+        using Second_Target = u16PackedRegisterData<u32, 6, 8>;
+
+        static constexpr u32 allLayers = (1 << 6) - 1;
+
+        ConditionallyVolatile_T<u16, Volatile> data;
+
+        BlendControlRegisterTemplate() = default;
+        BlendControlRegisterTemplate(const BlendControlRegisterTemplate<!Volatile>& other) :
+            data{ other.data }
+        {
+
+        }
+
+        BlendControlRegisterTemplate& operator=(const BlendControlRegisterTemplate& other) = default;
+        BlendControlRegisterTemplate& operator=(const BlendControlRegisterTemplate<!Volatile>& other)
+        {
+            data = other.data;
+            return *this;
+        }
+
+        void EnableFirstTarget(BlendLayer layer)
+        {
+            data |= First_Target::bitMask & (1 << static_cast<u32>(layer));
+        }
+
+        void DisableFirstTarget(BlendLayer layer)
+        {
+            data &= ~(1 << static_cast<u32>(layer));
+        }
+
+        WordBool IsFirstTarget(BlendLayer layer) const
+        {
+            return (First_Target::Get(data) >> static_cast<u32>(layer)) & 1;
+        }
+
+        //Bit n of layers is BlendLayer n
+        void SetFirstTargets(First_Target::type layers)
+        {
+            First_Target::Set(data, layers);
+        }
+
+        First_Target::type GetFirstTargets() const
+        {
+            return First_Target::Get(data);
+        }
+
+        void EnableSecondTarget(BlendLayer layer)
+        {
+            data |= Second_Target::bitMask & (1 << (static_cast<u32>(layer) + Second_Target::bitShift));
+        }
+
+        void DisableSecondTarget(BlendLayer layer)
+        {
+            data &= ~(1 << (static_cast<u32>(layer) + Second_Target::bitShift));
+        }
+
+        WordBool IsSecondTarget(BlendLayer layer) const
+        {
+            return (Second_Target::Get(data) >> static_cast<u32>(layer)) & 1;
+        }
+
+        void SetSecondTargets(Second_Target::type layers)
+        {
+            Second_Target::Set(data, layers);
+        }
+
+        Second_Target::type GetSecondTargets() const
+        {
+            return Second_Target::Get(data);
+        }
+
+        void SetEffect(Effect::type value)
+        {
+            Effect::Set(data, value);
+        }
+
+        Effect::type GetEffect() const
+        {
+            return Effect::Get(data);
+        }
+    };
+
+    using BlendControlRegister = BlendControlRegisterTemplate<false>;
+    using VolatileBlendControlRegister = BlendControlRegisterTemplate<true>;
+
+    //Weights are in 16ths, the hardware treats anything above 16 as 16
+    template<bool Volatile>
+    struct BlendAlphaRegisterTemplate
+    {
+        using First_Target_Weight = u16PackedRegisterData<Range<u32, 0, 16>, 5, 0>;
+        using Second_Target_Weight = u16PackedRegisterData<Range<u32, 0, 16>, 5, 8>;
+
+        ConditionallyVolatile_T<u16, Volatile> data;
+
+        BlendAlphaRegisterTemplate() = default;
+        BlendAlphaRegisterTemplate(const BlendAlphaRegisterTemplate<!Volatile>& other) :
+            data{ other.data }
+        {
+
+        }
+
+        BlendAlphaRegisterTemplate& operator=(const BlendAlphaRegisterTemplate& other) = default;
+        BlendAlphaRegisterTemplate& operator=(const BlendAlphaRegisterTemplate<!Volatile>& other)
+        {
+            data = other.data;
+            return *this;
+        }
+
+        void SetFirstTargetWeight(First_Target_Weight::type value)
+        {
+            First_Target_Weight::Set(data, value);
+        }
+
+        First_Target_Weight::type GetFirstTargetWeight() const
+        {
+            return First_Target_Weight::Get(data);
+        }
+
+        void SetSecondTargetWeight(Second_Target_Weight::type value)
+        {
+            Second_Target_Weight::Set(data, value);
+        }
+
+        Second_Target_Weight::type GetSecondTargetWeight() const
+        {
+            return Second_Target_Weight::Get(data);
+        }
+    };
+
+    using BlendAlphaRegister = BlendAlphaRegisterTemplate<false>;
+    using VolatileBlendAlphaRegister = BlendAlphaRegisterTemplate<true>;
+
+    //BLDY can't be read back, so it's only ever written as a whole
+    struct BlendBrightnessRegister
+    {
+        using Brightness_Weight = u16PackedRegisterData<Range<u32, 0, 16>, 5, 0>;
+
+        u16 data = 0;
+
+        BlendBrightnessRegister() = default;
+        explicit BlendBrightnessRegister(Brightness_Weight::type weight)
+        {
+            Brightness_Weight::Set(data, weight);
+        }
+    };
+
+    static_assert(sizeof(BlendControlRegister) == 2);
+    static_assert(sizeof(BlendAlphaRegister) == 2);
+    static_assert(sizeof(BlendBrightnessRegister) == 2);
+
+    struct Blend
+    {
+        static VolatileBlendControlRegister& GetControlRegister()
+        {
+            return Memory<VolatileBlendControlRegister>(blend_control_register);
+        }
+
+        static VolatileBlendAlphaRegister& GetAlphaRegister()
+        {
+            return Memory<VolatileBlendAlphaRegister>(blend_alpha_register);
+        }
+
+        static void SetBrightness(BlendBrightnessRegister::Brightness_Weight::type weight)
+        {
+            Memory<volatile u16>(blend_brightness_register) = BlendBrightnessRegister{ weight }.data;
+        }
+
+        static void SetAlpha(BlendAlphaRegister::First_Target_Weight::type firstWeight, BlendAlphaRegister::Second_Target_Weight::type secondWeight)
+        {
+            BlendAlphaRegister alpha{};
+            alpha.SetFirstTargetWeight(firstWeight);
+            alpha.SetSecondTargetWeight(secondWeight);
+            GetAlphaRegister() = alpha;
+        }
+
+        static void Disable()
+        {
+            GetControlRegister() = BlendControlRegister{};
+        }
+    };
+
+    //Fades the whole screen through BLDY, one register write per frame whatever the palettes hold.
+    //Objects in semi transparent mode ignore brightness effects
+    class ScreenFade
+    {
+    public:
+        static constexpr u32 maxBrightness = 16;
+
+    private:
+        BlendEffect effect = BlendEffect::None;
+        u32 frames = 0;
+        u32 elapsed = 0;
+        u32 target = maxBrightness;
+        WordBool fadingIn = false;
+
+    public:
+        //Fades out towards black or white over frames frames, stopping at target sixteenths of the way,
+        //or back in from there when fadingIn is set
+        void Start(BlendEffect _effect, u32 _frames, Range<u32, 0, maxBrightness> _target = maxBrightness, WordBool _fadingIn = false)
+        {
+            CGBA_ASSERT(_effect == BlendEffect::Brighten || _effect == BlendEffect::Darken, "Screen fades go towards black or white");
+            effect = _effect;
+            frames = _frames;
+            elapsed = 0;
+            target = _target;
+            fadingIn = _fadingIn;
+
+            BlendControlRegister control{};
+            control.SetFirstTargets(BlendControlRegister::allLayers);
+            control.SetEffect(effect);
+            Blend::GetControlRegister() = control;
+            Blend::SetBrightness(GetBrightness());
+        }
+
+        //Call once per frame, during VBlank to avoid changing the brightness halfway down the screen
+        void Update()
+        {
+            if(effect == BlendEffect::None || IsDone())
+                return;
+
+            elapsed++;
+            Blend::SetBrightness(GetBrightness());
+        }
+
+        //Turns the effect off, showing the screen as is
+        void Stop()
+        {
+            effect = BlendEffect::None;
+            Blend::Disable();
+            Blend::SetBrightness(0);
+        }
+
+        WordBool IsDone() const { return elapsed >= frames; }
+
+        u32 GetBrightness() const
+        {
+            const u32 progress = frames == 0 ? target : target * elapsed / frames;
+            return fadingIn ? target - progress : progress;
+        }
+    };
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "Types.hpp"
+#include "PackedRegister.hpp"
+#include "VRAMFormats.hpp"
+#include <limits>
+#include "Sections.hpp"
+
+namespace cgba
+{
+    enum class CompressionType : u32
+    {
+        LZ77 = 1,
+        Huffman = 2,
+        Run_Length = 3
+    };
+
+    //Header shared by the BIOS compatible formats, tools/compressor.py produces data starting with it
+    struct CompressionHeader
+    {
+        using Huffman_Unit_Size = PackedRegisterData<u32, u32, 4, 0>;
+        using Type = PackedRegisterData<u32, CompressionType, 4, 4>;
+
+        u32 data;
+
+        CompressionType GetType() const
+        {
+            return Type::Get(data);
+        }
+
+        //Size in bits of the symbols stored in the huffman tree, either 4 or 8
+        u32 GetHuffmanUnitSize() const
+        {
+            return Huffman_Unit_Size::Get(data);
+        }
+
+        u32 GetDecompressedSize() const
+        {
+            return data >> 8;
+        }
+    };
+
+    enum class DecompressionMethod : u32
+    {
+        //ARM code running from IWRAM
+        Software = 0,
+
+        //BIOS SWI calls, using the variants that write 16 bits at a time when available
+        Bios = 1
+    };
+
+    //Decompresses a stream into VRAM using halfword writes only, in as many Decode calls as wanted so the work can be spread across frames.
+    //The source must be 4 byte aligned and stay valid until decoding finishes
+    class Decompressor
+    {
+    private:
+        const u8* source;
+        volatile u16* destination;
+        CompressionHeader header;
+        u32 written = 0;
+        u16 pendingHalfword = 0;
+
+        //LZ77 and run length state
+        u32 blockFlags = 0;
+        u32 blockFlagsRemaining = 0;
+        u32 repeatRemaining = 0;
+        u32 repeatDistance = 0;
+        u32 repeatValue = 0;
+        WordBool repeatIsRun = false;
+
+        //Huffman state
+        const u8* treeRoot = nullptr;
+        const u32* bitstream = nullptr;
+        u32 bits = 0;
+        u32 bitsRemaining = 0;
+        u32 unitAccumulator = 0;
+        u32 unitAccumulatorSize = 0;
+
+    public:
+        Decompressor(const void* _source, volatile u16* _destination);
+
+        //Decodes until at least maxBytes more bytes have been written or the stream ends, returns true once the stream has been fully written
+        CGBA_CODE_IWRAM WordBool Decode(u32 maxBytes = std::numeric_limits<u32>::max());
+
+        WordBool IsDone() const { return written == header.GetDecompressedSize(); }
+        u32 GetWrittenSize() const { return written; }
+        CompressionHeader GetHeader() const { return header; }
+
+    private:
+        CGBA_CODE_IWRAM void DecodeLZ77(u32 target);
+        CGBA_CODE_IWRAM void DecodeRunLength(u32 target);
+        CGBA_CODE_IWRAM void DecodeHuffman(u32 target);
+
+        void Write(u32 value)
+        {
+            if(written & 1)
+                destination[written >> 1] = static_cast<u16>(pendingHalfword | (value << 8));
+            else
+                pendingHalfword = static_cast<u16>(value);
+            written++;
+        }
+
+        u32 Read(u32 index) const
+        {
+            if((index >> 1) == (written >> 1))
+                return pendingHalfword & 0xFF;
+            return (destination[index >> 1] >> ((index & 1) * 8)) & 0xFF;
+        }
+
+        //An odd sized stream leaves its last byte pending, merge it without touching the byte after the stream
+        void Flush()
+        {
+            if(written & 1)
+                destination[written >> 1] = static_cast<u16>((destination[written >> 1] & 0xFF00) | pendingHalfword);
+        }
+    };
+
+    void Decompress(const void* source, volatile u16* destination, DecompressionMethod method = DecompressionMethod::Software);
+
+    struct DecompressionTiming
+    {
+        u32 softwareCycles;
+        u32 biosCycles;
+    };
+
+    //Decompresses source with each method in turn and times both with the timers of CycleCounter<>,
+    //to pick the faster method for an asset on hardware. Both write the same data to destination
+    DecompressionTiming CompareDecompression(const void* source, volatile u16* destination);
+
+    template<PaletteMode Mode>
+    void Decompress(const void* source, CharacterBlockViewTemplate<Mode> view, u32 firstTile = 0, DecompressionMethod method = DecompressionMethod::Software)
+    {
+        Decompress(source, reinterpret_cast<volatile u16*>(&view[firstTile]), method);
+    }
+
+    inline void Decompress(const void* source, TextScreenBlockView view, DecompressionMethod method = DecompressionMethod::Software)
+    {
+        Decompress(source, reinterpret_cast<volatile u16*>(&view[0u]), method);
+    }
+
+    //The data must already be laid out in hardware screen block order
+    template<TextScreenSizeMode SizeMode>
+    void Decompress(const void* source, StaticTextScreenBlockView<SizeMode> view, DecompressionMethod method = DecompressionMethod::Software)
+    {
+        Decompress(source, reinterpret_cast<volatile u16*>(&view[0u]), method);
+    }
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Assert.hpp"
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <utility>
+
+namespace cgba
+{
+    //Coroutine that a TaskScheduler resumes once per frame after VBlank, for work spread over several frames.
+    //Frames come from a fixed pool instead of the heap, a coroutine whose locals don't fit asserts on creation
+    class Task
+    {
+    public:
+        static constexpr u32 maxFrameSize = 256;
+        static constexpr u32 maxFrames = 16;
+
+        struct promise_type
+        {
+            //Frames left to wait, or the DMA channel to wait for when waitingForDma is set
+            u32 framesRemaining = 0;
+            u32 dmaChannel = 0;
+            WordBool waitingForDma = false;
+
+            Task get_return_object() { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() {}
+
+            static void* operator new(std::size_t size) noexcept;
+            static void operator delete(void* frame) noexcept;
+            static Task get_return_object_on_allocation_failure() { return Task{ nullptr }; }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+    private:
+        Handle handle;
+
+    public:
+        explicit Task(Handle _handle) :
+            handle{ _handle }
+        {
+
+        }
+
+        Task(Task&& other) noexcept :
+            handle{ std::exchange(other.handle, nullptr) }
+        {
+
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if(this != &other)
+            {
+                Destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            Destroy();
+        }
+
+        WordBool IsValid() const { return static_cast<bool>(handle); }
+        WordBool IsDone() const { return !handle || handle.done(); }
+
+        //Gives up ownership, the caller destroys the frame
+        Handle Release() { return std::exchange(handle, nullptr); }
+
+    private:
+        void Destroy()
+        {
+            if(handle)
+                handle.destroy();
+            handle = nullptr;
+        }
+    };
+
+    //co_await Frames(n) resumes after n more VBlanks, Frames(0) doesn't suspend
+    struct Frames
+    {
+        u32 count;
+
+        explicit Frames(u32 _count) :
+            count{ _count }
+        {
+
+        }
+
+        bool await_ready() const noexcept { return count == 0; }
+        void await_suspend(Task::Handle handle) const noexcept { handle.promise().framesRemaining = count; }
+        void await_resume() const noexcept {}
+    };
+
+    inline Frames NextFrame()
+    {
+        return Frames{ 1 };
+    }
+
+    //co_await DmaDone(channel) resumes after the first VBlank at which the channel has finished
+    struct DmaDone
+    {
+        u32 channel;
+
+        explicit DmaDone(Range<u32, 0, 3> _channel) :
+            channel{ _channel }
+        {
+
+        }
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Task::Handle handle) const noexcept
+        {
+            handle.promise().waitingForDma = true;
+            handle.promise().dmaChannel = channel;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    //Runs tasks from the start of VBlank, higher priorities first and tasks of equal priority in the order they were spawned.
+    //A task runs until its next co_await, so long loops need one every so often to leave time for the rest of the frame
+    class TaskScheduler
+    {
+    public:
+        static constexpr u32 maxTasks = Task::maxFrames;
+
+    private:
+        struct Entry
+        {
+            Task::Handle handle;
+            i32 priority;
+        };
+
+        std::array<Entry, maxTasks> tasks{};
+        u32 taskCount = 0;
+
+        //Tasks spawned by a task while RunVBlank is going through tasks, added once the pass is done
+        std::array<Entry, maxTasks> spawned{};
+        u32 spawnedCount = 0;
+        WordBool running = false;
+
+    public:
+        TaskScheduler() = default;
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+        ~TaskScheduler();
+
+        //The task first runs on the next RunVBlank, even when spawned from a running task.
+        //Returns false when the task is invalid or the scheduler is full
+        WordBool Spawn(Task task, i32 priority = 0);
+
+        //Call right after VBlank starts
+        void RunVBlank();
+
+        void Clear();
+        u32 GetTaskCount() const { return taskCount + spawnedCount; }
+        WordBool IsIdle() const { return GetTaskCount() == 0; }
+
+    private:
+        void Insert(const Entry& entry);
+    };
+}
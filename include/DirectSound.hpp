@@ -0,0 +1,87 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Sound.hpp"
+#include "Mixer.hpp"
+#include <array>
+
+namespace cgba
+{
+    //Output rates whose sample period divides the 280896 cycles of a frame, so every frame plays a whole buffer.
+    //The value is the number of samples per frame, a multiple of the 16 bytes the FIFO DMA moves at a time
+    enum class DirectSoundRate : u32
+    {
+        Hz10512 = 176,
+        Hz13379 = 224,
+        Hz18157 = 304,
+        Hz21024 = 352,
+        Hz26758 = 448,
+        Hz31536 = 528,
+        Hz36314 = 608,
+        Hz40137 = 672,
+        Hz42048 = 704
+    };
+
+    //Plays a Mixer through one DirectSound FIFO with two frame sized buffers laid out back to back: the FIFO DMA reads the one mixed
+    //during the last frame while Mix fills the other. A timer pops one sample every period, and each pop the FIFO runs low refills it
+    //by DMA, which reads 16 to 32 samples ahead of what plays. The read ahead runs on from the first buffer into the second, and from
+    //the second into a copy of the first buffer's head, so the DMA is only restarted every other frame and playback has no gaps.
+    //Defaults leave FIFO A, DMA 1 and timer 0 to Butano's Maxmod
+    class DirectSound
+    {
+    public:
+        static constexpr u32 cyclesPerFrame = 280896;
+        static constexpr u32 cpuFrequency = 1 << 24;
+        static constexpr u32 maxSamplesPerFrame = static_cast<u32>(DirectSoundRate::Hz42048);
+
+        static constexpr u32 GetSamplesPerFrame(DirectSoundRate rate) { return static_cast<u32>(rate); }
+        static constexpr u32 GetCyclesPerSample(DirectSoundRate rate) { return cyclesPerFrame / GetSamplesPerFrame(rate); }
+        static constexpr u32 GetSampleRate(DirectSoundRate rate) { return cpuFrequency / GetCyclesPerSample(rate); }
+
+    private:
+        Mixer mixer;
+        SoundFifo fifo;
+        u32 timer;
+        u32 samplesPerFrame;
+        u32 cyclesPerSample;
+
+        //Bytes the FIFO DMA has read past the end of the second buffer when CommitVBlank wraps back to the first
+        static constexpr u32 wrapReadAhead = 16;
+        static constexpr u32 guardSize = 32;
+
+        //The first sample pops this many periods after the timer starts, see StartHardware
+        static constexpr u32 startDelay = 9;
+
+        //Both buffers, samplesPerFrame apart, followed by guardSize samples copied from the start of the first one
+        alignas(4) std::array<i8, 2 * maxSamplesPerFrame + guardSize> buffers{};
+        u32 playingBuffer = 0;
+        WordBool running = false;
+        WordBool pendingStart = false;
+
+    public:
+        explicit DirectSound(DirectSoundRate rate = DirectSoundRate::Hz18157, SoundFifo _fifo = SoundFifo::B, Range<u32, 0, 1> _timer = 1);
+        ~DirectSound();
+
+        DirectSound(const DirectSound&) = delete;
+        DirectSound& operator=(const DirectSound&) = delete;
+
+        //Starts playing silence from the next CommitVBlank, sounds started on the mixer are heard from the second frame after they're mixed
+        void Start();
+        void Stop();
+
+        //Switches to the buffer mixed during the last frame, restarting the FIFO DMA when that is the first one.
+        //Call first thing in VBlank so the buffers stay in step with the timer
+        void CommitVBlank();
+
+        //Mixes the next frame into the buffer that isn't playing, once per frame after CommitVBlank
+        void Mix();
+
+        Mixer& GetMixer() { return mixer; }
+        WordBool IsRunning() const { return running; }
+
+    private:
+        i8* GetBuffer(u32 index) { return buffers.data() + index * samplesPerFrame; }
+        void StartHardware();
+        void StartDma(const i8* source);
+    };
+}
@@ -6,8 +6,9 @@
 #include "VRAMFormats.hpp"
 #include <limits>
 #include <bit>
-#include "bn_assert.h"
+#include "Assert.hpp"
 #include "PackedRegister.hpp"
+#include "Register.hpp"
 
 namespace cgba
 {   
@@ -98,12 +99,12 @@ namespace cgba
         
         void SetForcedBlankFlag()
         {
-            OBJ_Character_VRAM_Mapping_Mode::Set(data);
+            Forced_Blank_Flag::Set(data);
         }
         
         void ResetForcedBlankFlag()
         {
-            OBJ_Character_VRAM_Mapping_Mode::Reset(data);
+            Forced_Blank_Flag::Reset(data);
         }
 
         Forced_Blank_Flag::type GetForcedBlankFlag() const
@@ -118,7 +119,7 @@ namespace cgba
 
         void HideBackground(Range<u32, 0, 3> layer)
         {
-            data &= Background0_Visibility_Flag::bitMask << layer;
+            data &= ~(Background0_Visibility_Flag::bitMask << layer);
         }
         // using Background0_Visibility_Flag = u16PackedRegisterData<u32, 1, 8>;
         // using Background1_Visibility_Flag = u16PackedRegisterData<u32, 1, 9>;
@@ -295,6 +296,9 @@ namespace cgba
 
     using DisplayStatusRegister = DisplayStatusRegisterTemplate<false>;
     using VolatileDisplayStatusRegister = DisplayStatusRegisterTemplate<true>;
+
+    using DisplayControl = IORegister<DisplayControlRegister, display_control_register>;
+    using DisplayStatus = IORegister<DisplayStatusRegister, display_status_register>;
     
     struct Display
     {
@@ -318,17 +322,14 @@ namespace cgba
         template<class Ty>
         static Ty& SetBackgroundMode()
         {
-            cgba::DisplayControlRegister currentStatus = GetControlRegister();
-            currentStatus.SetBackgroundMode(Ty::modeValue);
-            GetControlRegister() = currentStatus;
+            DisplayControl::Modify([](DisplayControlRegister& control){ control.SetBackgroundMode(Ty::modeValue); });
             return Ty::_dummy;
         }
 
         template<class Ty>
         static Ty& GetBackgroundMode()
         {
-            ////TODO: Maybe get an assert that doesn't rely on BN?
-            BN_ASSERT(GetControlRegister().GetBackgroundMode() == Ty::modeValue);
+            CGBA_ASSERT(DisplayControl::Load().GetBackgroundMode() == Ty::modeValue);
             return Ty::_dummy;
         }
     };
@@ -463,12 +464,23 @@ namespace cgba
 
 
     static_assert(sizeof(BackgroundControlRegister) == 2, "The docs says background control register is 2 bytes");
-    
+
+    //BGxHOFS and BGxVOFS are next to each other, so one word store sets both offsets of a layer
     struct BackgroundScrollRegister
     {
-        volatile Point<i32> offset;
+        u32 data;
+
+        BackgroundScrollRegister() = default;
+        BackgroundScrollRegister(Point<u16> offset) :
+            data{ offset.x | (static_cast<u32>(offset.y) << 16) }
+        {
+
+        }
     };
 
+    using BackgroundControl = IORegister<BackgroundControlRegister, background_control_register_base_address, RegisterAccess::ReadWrite, 4>;
+    using BackgroundScroll = IORegister<BackgroundScrollRegister, background_scroll_offset_register_base_address, RegisterAccess::WriteOnly, 4>;
+
     struct AffineTransform
     {
         Fixed<i16, 8> x; 
@@ -576,7 +588,7 @@ namespace cgba
 
         void Hide()
         {
-            Display::GetControlRegister().ShowBackground(layer);
+            Display::GetControlRegister().HideBackground(layer);
         }
 
         i32 GetLayer() const { return layer; }
@@ -746,40 +758,44 @@ namespace cgba
         template<TextScreenSizeMode SizeMode, PaletteMode Palette>
         static StaticTileBackgroundView<SizeMode, Palette> MakeStaticBackground0()
         {
-            BackgroundControlRegister reg =  GetBackground0().GetControlRegister();
-            reg.SetScreenSizeText(SizeMode);
-            reg.SetPaletteMode(Palette);
-            GetBackground0().GetControlRegister() = reg;
+            BackgroundControl::Modify([](BackgroundControlRegister& reg)
+            {
+                reg.SetScreenSizeText(SizeMode);
+                reg.SetPaletteMode(Palette);
+            }, 0);
             return StaticTileBackgroundView<SizeMode, Palette>{0};
         }
         
         template<TextScreenSizeMode SizeMode, PaletteMode Palette>
         static StaticTileBackgroundView<SizeMode, Palette> MakeStaticBackground1()
         {
-            BackgroundControlRegister reg =  GetBackground1().GetControlRegister();
-            reg.SetScreenSizeText(SizeMode);
-            reg.SetPaletteMode(Palette);
-            GetBackground1().GetControlRegister() = reg;
+            BackgroundControl::Modify([](BackgroundControlRegister& reg)
+            {
+                reg.SetScreenSizeText(SizeMode);
+                reg.SetPaletteMode(Palette);
+            }, 1);
             return StaticTileBackgroundView<SizeMode, Palette>{1};
         }
         
         template<TextScreenSizeMode SizeMode, PaletteMode Palette>
         static StaticTileBackgroundView<SizeMode, Palette> MakeStaticBackground2()
         {
-            BackgroundControlRegister reg =  GetBackground2().GetControlRegister();
-            reg.SetScreenSizeText(SizeMode);
-            reg.SetPaletteMode(Palette);
-            GetBackground2().GetControlRegister() = reg;
+            BackgroundControl::Modify([](BackgroundControlRegister& reg)
+            {
+                reg.SetScreenSizeText(SizeMode);
+                reg.SetPaletteMode(Palette);
+            }, 2);
             return StaticTileBackgroundView<SizeMode, Palette>{2};
         }
         
         template<TextScreenSizeMode SizeMode, PaletteMode Palette>
         static StaticTileBackgroundView<SizeMode, Palette> MakeStaticBackground3()
         {
-            BackgroundControlRegister reg =  GetBackground3().GetControlRegister();
-            reg.SetScreenSizeText(SizeMode);
-            reg.SetPaletteMode(Palette);
-            GetBackground3().GetControlRegister() = reg;
+            BackgroundControl::Modify([](BackgroundControlRegister& reg)
+            {
+                reg.SetScreenSizeText(SizeMode);
+                reg.SetPaletteMode(Palette);
+            }, 3);
             return StaticTileBackgroundView<SizeMode, Palette>{3};
         }
         
@@ -893,25 +909,32 @@ namespace cgba
     };
 
     
-    inline void BadPresent()
+    //whileWaiting is called repeatedly while busy waiting, for work that has to happen at points during the frame like sampling input
+    template<class Func>
+    void BadPresent(Func&& whileWaiting)
     {
-        auto completeVBlank = []
+        auto completeVBlank = [&]
         {
             while(cgba::Display::GetVerticalCounter() >= 160)
             {
-
+                whileWaiting();
             }
         };
 
-        auto waitForVBlank = []
+        auto waitForVBlank = [&]
         {
             while(cgba::Display::GetVerticalCounter() < 160)
             {
-
+                whileWaiting();
             }
         };
 
         completeVBlank();
         waitForVBlank();
     }
+
+    inline void BadPresent()
+    {
+        BadPresent([]{});
+    }
 }
\ No newline at end of file
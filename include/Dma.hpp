@@ -0,0 +1,208 @@
+#pragma once
+#include "Types.hpp"
+#include "MemoryRegion.hpp"
+#include "Math.hpp"
+#include "PackedRegister.hpp"
+
+namespace cgba
+{
+    enum class DmaAddressControl : u32
+    {
+        Increment = 0,
+        Decrement = 1,
+        Fixed = 2,
+
+        //Destination only, increments during the transfer and goes back to the start address when the transfer repeats
+        Increment_Reload = 3
+    };
+
+    enum class DmaTransferType : u32
+    {
+        Bits16 = 0,
+        Bits32 = 1
+    };
+
+    enum class DmaStartTiming : u32
+    {
+        Immediately = 0,
+        VBlank = 1,
+        HBlank = 2,
+
+        //Sound FIFO for DMA 1 and 2, video capture for DMA 3
+        Special = 3
+    };
+
+    template<bool Volatile>
+    struct DmaControlRegisterTemplate
+    {
+        using Destination_Address_Control = u16PackedRegisterData<DmaAddressControl, 2, 5>;
+        using Source_Address_Control = u16PackedRegisterData<DmaAddressControl, 2, 7>;
+        using Repeat = u16PackedRegisterData<WordBool, 1, 9>;
+        using Transfer_Type = u16PackedRegisterData<DmaTransferType, 1, 10>;
+        using Start_Timing = u16PackedRegisterData<DmaStartTiming, 2, 12>;
+        using Enable_IRQ = u16PackedRegisterData<WordBool, 1, 14>;
+        using Dma_Enable = u16PackedRegisterData<WordBool, 1, 15>;
+
+        ConditionallyVolatile_T<u16, Volatile> data;
+
+        DmaControlRegisterTemplate() = default;
+        DmaControlRegisterTemplate(const DmaControlRegisterTemplate<!Volatile>& other) :
+            data{ other.data }
+        {
+
+        }
+
+        DmaControlRegisterTemplate& operator=(const DmaControlRegisterTemplate& other) = default;
+        DmaControlRegisterTemplate& operator=(const DmaControlRegisterTemplate<!Volatile>& other)
+        {
+            data = other.data;
+            return *this;
+        }
+
+        void SetDestinationAddressControl(Destination_Address_Control::type value)
+        {
+            Destination_Address_Control::Set(data, value);
+        }
+
+        Destination_Address_Control::type GetDestinationAddressControl() const
+        {
+            return Destination_Address_Control::Get(data);
+        }
+
+        void SetSourceAddressControl(Source_Address_Control::type value)
+        {
+            Source_Address_Control::Set(data, value);
+        }
+
+        Source_Address_Control::type GetSourceAddressControl() const
+        {
+            return Source_Address_Control::Get(data);
+        }
+
+        void EnableRepeat()
+        {
+            Repeat::Set(data);
+        }
+
+        void DisableRepeat()
+        {
+            Repeat::Reset(data);
+        }
+
+        void SetTransferType(Transfer_Type::type value)
+        {
+            Transfer_Type::Set(data, value);
+        }
+
+        Transfer_Type::type GetTransferType() const
+        {
+            return Transfer_Type::Get(data);
+        }
+
+        void SetStartTiming(Start_Timing::type value)
+        {
+            Start_Timing::Set(data, value);
+        }
+
+        Start_Timing::type GetStartTiming() const
+        {
+            return Start_Timing::Get(data);
+        }
+
+        void EnableIRQ()
+        {
+            Enable_IRQ::Set(data);
+        }
+
+        void DisableIRQ()
+        {
+            Enable_IRQ::Reset(data);
+        }
+
+        void Enable()
+        {
+            Dma_Enable::Set(data);
+        }
+
+        void Disable()
+        {
+            Dma_Enable::Reset(data);
+        }
+
+        //Immediate transfers clear the flag once done, repeating ones keep it set until disabled
+        Dma_Enable::type IsEnabled() const
+        {
+            return Dma_Enable::Get(data);
+        }
+    };
+
+    using DmaControlRegister = DmaControlRegisterTemplate<false>;
+    using VolatileDmaControlRegister = DmaControlRegisterTemplate<true>;
+
+    static_assert(sizeof(DmaControlRegister) == 2);
+
+    struct DmaChannelRegisters
+    {
+        const volatile void* volatile source;
+        volatile void* volatile destination;
+        volatile u16 count;
+        VolatileDmaControlRegister control;
+    };
+
+    static_assert(sizeof(DmaChannelRegisters) == dma_register_increments);
+
+    struct Dma
+    {
+        static DmaChannelRegisters& GetChannel(Range<u32, 0, 3> channel)
+        {
+            return Memory<DmaChannelRegisters>(dma_registers_base_address + dma_register_increments * channel);
+        }
+
+        //Count is in transfer units (halfwords or words), 0 meaning the maximum of the channel.
+        //Writing the control register last starts the transfer, or arms it when the timing isn't immediate
+        static void Start(Range<u32, 0, 3> channel, const volatile void* source, volatile void* destination, u16 count, DmaControlRegister control)
+        {
+            DmaChannelRegisters& registers = GetChannel(channel);
+            registers.control = DmaControlRegister{};
+            registers.source = source;
+            registers.destination = destination;
+            registers.count = count;
+            control.Enable();
+            registers.control = control;
+        }
+
+        static void Stop(Range<u32, 0, 3> channel)
+        {
+            GetChannel(channel).control = DmaControlRegister{};
+        }
+
+        static WordBool IsBusy(Range<u32, 0, 3> channel)
+        {
+            return GetChannel(channel).control.IsEnabled();
+        }
+
+        //The CPU is halted until an immediate transfer completes
+        static void Copy16(const volatile void* source, volatile void* destination, u32 halfwordCount)
+        {
+            DmaControlRegister control{};
+            control.SetTransferType(DmaTransferType::Bits16);
+            Start(3, source, destination, static_cast<u16>(halfwordCount), control);
+        }
+
+        static void Copy32(const volatile void* source, volatile void* destination, u32 wordCount)
+        {
+            DmaControlRegister control{};
+            control.SetTransferType(DmaTransferType::Bits32);
+            Start(3, source, destination, static_cast<u16>(wordCount), control);
+        }
+
+        //Picks 32 bit transfers when both addresses and the size allow it
+        static void Copy(const volatile void* source, volatile void* destination, u32 bytes)
+        {
+            if(((reinterpret_cast<uintptr>(source) | reinterpret_cast<uintptr>(destination) | bytes) & 3) == 0)
+                Copy32(source, destination, bytes / sizeof(u32));
+            else
+                Copy16(source, destination, bytes / sizeof(u16));
+        }
+    };
+}
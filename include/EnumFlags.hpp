@@ -72,6 +72,7 @@ namespace cgba
         return lh = lh ^ rh;    \
     }  
 
+//Compound assignments read the register once and write it once, returning the written value instead of reading it back
 #define DECLARE_VOLATILE_BIT_FLAG_OPS2(Type, Type2) \
     inline Type operator|(const volatile Type& lh, const Type2& rh)  \
     {   \
@@ -87,24 +88,21 @@ namespace cgba
     }   \
     inline Type operator|=(volatile Type& lh, const Type2& rh)   \
     {   \
-        Type temp = lh;\
-        temp |= rh;\
-        lh = temp;\
-        return lh;    \
+        const Type result = lh | rh;    \
+        lh = result;    \
+        return result;    \
     }   \
     inline Type operator&=(volatile Type& lh, const Type2& rh)   \
     {   \
-        Type temp = lh;\
-        temp &= rh;\
-        lh = temp;\
-        return lh;    \
+        const Type result = lh & rh;    \
+        lh = result;    \
+        return result;    \
     }   \
     inline Type operator^=(volatile Type& lh, const Type2& rh)   \
     {   \
-        Type temp = lh;\
-        temp ^= rh;\
-        lh = temp;\
-        return lh;    \
+        const Type result = lh ^ rh;    \
+        lh = result;    \
+        return result;    \
     }
     
     #define DECLARE_BIT_FLAG_OPS(Type) DECLARE_BIT_FLAG_OPS2(Type, Type) \
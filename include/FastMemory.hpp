@@ -0,0 +1,75 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Sections.hpp"
+
+//Implemented in src/FastMemory.s, addresses must be word aligned
+extern "C"
+{
+    CGBA_CODE_IWRAM void cgba_memcpy32(void* destination, const void* source, cgba::u32 wordCount);
+    CGBA_CODE_IWRAM void cgba_memset32(void* destination, cgba::u32 value, cgba::u32 wordCount);
+    CGBA_CODE_IWRAM void cgba_convert_tiles_16_to_256(void* destination, const void* source, cgba::u32 tileCount, cgba::u32 paletteNumber);
+}
+
+namespace cgba
+{
+    //Copies and fills for VRAM, palette RAM and IWRAM, which all take 32 bit stores.
+    //The 16 bit variants fall back to a halfword at each unaligned end
+    struct FastMemory
+    {
+        static WordBool IsWordAligned(const volatile void* address)
+        {
+            return (reinterpret_cast<uintptr>(address) & 3) == 0;
+        }
+
+        static void Copy32(volatile void* destination, const volatile void* source, u32 wordCount)
+        {
+            cgba_memcpy32(const_cast<void*>(destination), const_cast<const void*>(source), wordCount);
+        }
+
+        static void Fill32(volatile void* destination, u32 value, u32 wordCount)
+        {
+            cgba_memset32(const_cast<void*>(destination), value, wordCount);
+        }
+
+        static void Copy16(volatile u16* destination, const volatile u16* source, u32 halfwordCount)
+        {
+            //Word copies only work when both sides share the same alignment
+            if(IsWordAligned(destination) != IsWordAligned(source))
+            {
+                for(u32 i = 0; i < halfwordCount; i++)
+                    destination[i] = source[i];
+                return;
+            }
+
+            if(!IsWordAligned(destination) && halfwordCount > 0)
+            {
+                *destination++ = *source++;
+                halfwordCount--;
+            }
+
+            Copy32(destination, source, halfwordCount / 2);
+            if(halfwordCount % 2)
+                destination[halfwordCount - 1] = source[halfwordCount - 1];
+        }
+
+        static void Fill16(volatile u16* destination, u16 value, u32 halfwordCount)
+        {
+            if(!IsWordAligned(destination) && halfwordCount > 0)
+            {
+                *destination++ = value;
+                halfwordCount--;
+            }
+
+            Fill32(destination, value | (static_cast<u32>(value) << 16), halfwordCount / 2);
+            if(halfwordCount % 2)
+                destination[halfwordCount - 1] = value;
+        }
+
+        //tileCount 16 color tiles from source become 256 color tiles at destination, see the CharacterTile256 constructor
+        static void ConvertTiles16To256(volatile void* destination, const void* source, u32 tileCount, Range<u32, 0, 15> paletteNumber)
+        {
+            cgba_convert_tiles_16_to_256(const_cast<void*>(destination), source, tileCount, paletteNumber);
+        }
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+
+namespace cgba
+{
+    //Runs a simulation at a fixed tick interval independent of how often frames are drawn.
+    //Time is counted in frames with 8 fractional bits, so intervals like 4.5 frames stay exact over any number of ticks.
+    //Advance is given the real time since the last call, or AdvanceScanlines the scanlines measured with FramePipeline::GetScanlineTime
+    class FixedTimestep
+    {
+    public:
+        using Time = Fixed<u32, 8>;
+
+        static constexpr u32 scanlinesPerFrame = 228;
+
+    private:
+        Time tickInterval;
+        Time accumulator{};
+
+        //Scanlines times 256 left over from converting to Time, carried so rounding never loses time
+        u32 scanlineRemainder = 0;
+        u32 maxTicksPerAdvance;
+        u32 droppedTicks = 0;
+
+    public:
+        //After a long stall at most maxTicksPerAdvance ticks run at once and the rest of the time is dropped,
+        //so one slow frame can't snowball into more and more catching up
+        explicit FixedTimestep(Time _tickInterval, u32 _maxTicksPerAdvance = 4);
+
+        //Adds elapsed time and returns how many ticks to run now
+        u32 Advance(Time elapsed = Time::FromInt(1));
+
+        //Converts to Time, carrying what doesn't divide evenly over to the next call
+        u32 AdvanceScanlines(u32 scanlines);
+
+        //Takes effect from the next tick, time already accumulated is kept
+        void SetTickInterval(Time interval);
+        Time GetTickInterval() const { return tickInterval; }
+
+        //How far rendering is between the last tick and the next one, from 0 to just under 1
+        Time GetAlpha() const { return accumulator / tickInterval; }
+
+        u32 GetDroppedTicks() const { return droppedTicks; }
+        void Reset();
+    };
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Display.hpp"
+#include "Input.hpp"
+
+namespace cgba
+{
+    struct LatencyStats
+    {
+        u32 last = 0;
+        u32 min = 0;
+        u32 max = 0;
+        u32 total = 0;
+        u32 count = 0;
+
+        u32 GetAverage() const { return count ? total / count : 0; }
+    };
+
+    //Orders a frame so input reaches the screen as soon as possible:
+    //wait until a late scanline, sample input and update, wait for VBlank, then commit the changes to VRAM.
+    //A change committed in VBlank is shown from line 0 of the next frame, so input sampled at inputLine is a little over
+    //a quarter of a frame old when it's displayed, instead of up to two frames when it's polled at the start of the frame.
+    //Latency is measured in scanlines from the first sample that saw a key go down until the start of the frame showing the result
+    class FramePipeline
+    {
+    public:
+        static constexpr u32 scanlineCount = 228;
+        static constexpr u32 defaultInputLine = 150;
+
+        using LatencyHook = void(*)(u32 scanlines);
+
+    private:
+        u32 inputLine;
+        u32 frame = 0;
+        u32 lastLine = 0;
+        u16 previousInput = 0;
+
+        u32 pendingInputTime = 0;
+        WordBool inputPending = false;
+        LatencyStats stats;
+        LatencyHook latencyHook = nullptr;
+
+    public:
+        //inputLine should leave enough visible lines for the update to finish before VBlank starts
+        explicit FramePipeline(Range<u32, 0, 159> _inputLine = defaultInputLine);
+
+        //Busy waits until inputLine of the next visible frame when called during VBlank, or of the current one otherwise,
+        //then returns the latched input. Returns straight away when the frame is already past inputLine, it ran late then
+        template<class Func>
+        KeyInput SampleInput(InputLatch& latch, Func&& whileWaiting)
+        {
+            auto Wait = [&]
+            {
+                GetScanlineTime();
+                whileWaiting();
+            };
+
+            while(Display::GetVerticalCounter() >= Display::hardwareScreenSizePixels.height)
+                Wait();
+            while(Display::GetVerticalCounter() < inputLine)
+                Wait();
+
+            const KeyInput input = latch.Consume();
+            const u32 now = GetScanlineTime();
+            if(latch.GetPressAge() > 0 || (input.data & ~previousInput))
+            {
+                pendingInputTime = now - latch.GetPressAge();
+                inputPending = true;
+            }
+            previousInput = input.data;
+            return input;
+        }
+
+        KeyInput SampleInput(InputLatch& latch)
+        {
+            return SampleInput(latch, [&]{ latch.SampleScheduled(); });
+        }
+
+        //Returns at the start of VBlank, VRAM writes made right after are shown from the next frame
+        template<class Func>
+        void WaitForVBlank(Func&& whileWaiting)
+        {
+            BadPresent([&]
+            {
+                GetScanlineTime();
+                whileWaiting();
+            });
+        }
+
+        //Call once the changes of the frame have been committed, reports the latency of input applied this frame
+        void EndFrame();
+
+        //Counts scanlines since the pipeline was created, has to be called at least once per frame to notice the counter wrapping
+        u32 GetScanlineTime();
+
+        void SetLatencyHook(LatencyHook hook) { latencyHook = hook; }
+        const LatencyStats& GetLatencyStats() const { return stats; }
+        void ResetLatencyStats() { stats = {}; }
+    };
+}
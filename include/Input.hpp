@@ -2,6 +2,8 @@
 #include "Types.hpp"
 #include "MemoryRegion.hpp"
 #include "EnumFlags.hpp"
+#include "Math.hpp"
+#include <array>
 
 namespace cgba
 {
@@ -42,8 +44,120 @@ namespace cgba
     public:
         void Poll();
 
+        //Advances a frame with input from somewhere else than KEYINPUT, like an InputLatch or an InputPlayer
+        void Poll(KeyInput input);
+
         WordBool Pressed(Key key) const;
         WordBool Held(Key key) const;
         WordBool Released(Key key) const;
+
+        KeyInput GetPrevious() const { return previous; }
+        KeyInput GetCurrent() const { return current; }
+    };
+
+    //Merges several samples of KEYINPUT into one frame of input, so a key held for less than a frame still shows up as held.
+    //SampleScheduled takes a sample whenever the scanline counter enters the next of sampleCount equal slots of the frame,
+    //so it needs to be called often, BadPresent(whileWaiting) is a good place for it
+    class InputLatch
+    {
+    private:
+        u16 latched = 0;
+        u16 consumed = 0;
+        u32 sampleInterval;
+        u32 lastSlot = 0;
+
+        //Scanline of the first sample that saw a key go down since the last Consume
+        u32 firstPressLine = 0;
+        WordBool pressSeen = false;
+        u32 pressAge = 0;
+
+    public:
+        explicit InputLatch(Range<u32, 1, 228> sampleCount = 4);
+
+        void Sample();
+        void SampleScheduled();
+
+        //Returns every key seen down since the last call, including the current state
+        KeyInput Consume();
+
+        //Scanlines between the first sample that saw a newly pressed key and the last Consume, 0 when nothing was pressed.
+        //Only meaningful when Consume is called about once per frame
+        u32 GetPressAge() const { return pressAge; }
+    };
+
+    enum class InputEventType : u32
+    {
+        Pressed,
+        Released
+    };
+
+    struct InputEvent
+    {
+        u32 frame;
+        Key key;
+        InputEventType type;
+    };
+
+    //Ring buffer of key transitions, the oldest events are dropped when it overflows
+    class InputEventQueue
+    {
+    public:
+        static constexpr u32 capacity = 32;
+
+    private:
+        std::array<InputEvent, capacity> events;
+        u32 first = 0;
+        u32 count = 0;
+        u32 dropped = 0;
+
+    public:
+        void Push(const InputEvent& event);
+
+        //Adds an event for every key that changed between the two inputs
+        void PushChanges(KeyInput previous, KeyInput current, u32 frame);
+
+        //Returns false when the queue is empty
+        WordBool Pop(InputEvent& event);
+
+        void Clear();
+        WordBool IsEmpty() const { return count == 0; }
+        u32 GetCount() const { return count; }
+        u32 GetDroppedCount() const { return dropped; }
+    };
+
+    //Run length encoded input, one word per run of identical frames with the keys in the low half and the frame count in the high half
+    class InputRecorder
+    {
+    private:
+        u32* runs;
+        u32 capacity;
+        u32 runCount = 0;
+
+    public:
+        InputRecorder(u32* _runs, u32 _capacity);
+
+        //Returns false once the buffer is full, the frame isn't recorded then
+        WordBool Record(KeyInput input);
+        void Reset() { runCount = 0; }
+
+        const u32* GetRuns() const { return runs; }
+        u32 GetRunCount() const { return runCount; }
+    };
+
+    class InputPlayer
+    {
+    private:
+        const u32* runs;
+        u32 runCount;
+        u32 run = 0;
+        u32 frameInRun = 0;
+
+    public:
+        InputPlayer(const u32* _runs, u32 _runCount);
+
+        //Returns no keys once the recording has ended
+        KeyInput Next();
+        void Rewind();
+        WordBool IsDone() const { return run == runCount; }
     };
 }
\ No newline at end of file
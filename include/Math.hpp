@@ -3,7 +3,9 @@
 #include <concepts>
 #include <climits>
 #include <limits>
-#include "bn_assert.h"
+#include <type_traits>
+#include <compare>
+#include "Assert.hpp"
 
 namespace cgba
 {
@@ -55,16 +57,67 @@ namespace cgba
     
     static_assert(std::numeric_limits<float>::is_iec559);
 
-    //TODO: Actually implement fixed point maths
+    //DecimalPoint is the number of fractional bits. Kept an aggregate so it can be laid over hardware registers
     template<std::integral Ty, i32 DecimalPoint>
         requires (DecimalPoint < sizeof(Ty) * CHAR_BIT)
     struct Fixed
     {
+        using WideType = std::conditional_t<std::is_signed_v<Ty>, long long, unsigned long long>;
+        static constexpr Ty one = static_cast<Ty>(1) << DecimalPoint;
+
         Ty data;
+
+        static constexpr Fixed FromInt(Ty value) { return { static_cast<Ty>(value << DecimalPoint) }; }
+        static constexpr Fixed FromRaw(Ty value) { return { value }; }
+
+        //Numerator / denominator rounded towards zero, for constants that aren't whole numbers
+        static constexpr Fixed FromFraction(Ty numerator, Ty denominator)
+        {
+            return { static_cast<Ty>((static_cast<WideType>(numerator) << DecimalPoint) / denominator) };
+        }
+
+        //Rounds towards negative infinity
+        constexpr Ty ToInt() const { return data >> DecimalPoint; }
+        constexpr Ty Raw() const { return data; }
+        constexpr Ty Fraction() const { return data & (one - 1); }
+
+        friend constexpr auto operator<=>(const Fixed& lh, const Fixed& rh) = default;
+
+        friend constexpr Fixed& operator+=(Fixed& lh, const Fixed& rh)
+        {
+            lh.data += rh.data;
+            return lh;
+        }
+
+        friend constexpr Fixed& operator-=(Fixed& lh, const Fixed& rh)
+        {
+            lh.data -= rh.data;
+            return lh;
+        }
+
+        friend constexpr Fixed operator+(Fixed lh, const Fixed& rh) { return lh += rh; }
+        friend constexpr Fixed operator-(Fixed lh, const Fixed& rh) { return lh -= rh; }
+
+        friend constexpr Fixed operator*(const Fixed& lh, const Fixed& rh)
+        {
+            return { static_cast<Ty>((static_cast<WideType>(lh.data) * rh.data) >> DecimalPoint) };
+        }
+
+        friend constexpr Fixed operator/(const Fixed& lh, const Fixed& rh)
+        {
+            return { static_cast<Ty>((static_cast<WideType>(lh.data) << DecimalPoint) / rh.data) };
+        }
+
+        friend constexpr Fixed operator*(const Fixed& lh, Ty rh) { return { static_cast<Ty>(lh.data * rh) }; }
+        friend constexpr Fixed operator/(const Fixed& lh, Ty rh) { return { static_cast<Ty>(lh.data / rh) }; }
     };
+
+    static_assert(Fixed<i32, 8>::FromInt(3) * Fixed<i32, 8>::FromFraction(1, 2) == Fixed<i32, 8>::FromFraction(3, 2));
+    static_assert((Fixed<i32, 8>::FromInt(-3) / Fixed<i32, 8>::FromInt(2)).ToInt() == -2);
     
 
-    //Min and Max are inclusive
+    //Min and Max are inclusive. Out of range constants are compile errors when the Range is constant evaluated,
+    //other values are only checked at runtime with CGBA_ASSERT_LEVEL 2
     template<class Ty, Ty Min, Ty Max>
     struct Range
     {
@@ -73,7 +126,7 @@ namespace cgba
         constexpr Range(Ty _value) :
             value{_value}
         {
-            BN_ASSERT(_value >= Min && _value <= Max);
+            CGBA_ASSERT(_value >= Min && _value <= Max, "Value is out of range");
         }
 
         constexpr operator Ty() const { return value; }
@@ -11,6 +11,33 @@ namespace cgba
     constexpr uintptr background_control_register_base_address = 0x0400'0008;
     constexpr uintptr background_scroll_offset_register_base_address = 0x0400'0010;
     constexpr uintptr background_rotation_scale_register_base_address = 0x0400'0020;
+    constexpr uintptr window_horizontal_register_base_address = 0x0400'0040;
+    constexpr uintptr window_vertical_register_base_address = 0x0400'0044;
+    constexpr uintptr window_inside_register = 0x0400'0048;
+    constexpr uintptr window_outside_register = 0x0400'004A;
+    constexpr uintptr blend_control_register = 0x0400'0050;
+    constexpr uintptr blend_alpha_register = 0x0400'0052;
+    constexpr uintptr blend_brightness_register = 0x0400'0054;
+    constexpr uintptr sound1_sweep_register = 0x0400'0060;
+    constexpr uintptr sound1_envelope_register = 0x0400'0062;
+    constexpr uintptr sound1_frequency_register = 0x0400'0064;
+    constexpr uintptr sound2_envelope_register = 0x0400'0068;
+    constexpr uintptr sound2_frequency_register = 0x0400'006C;
+    constexpr uintptr sound3_select_register = 0x0400'0070;
+    constexpr uintptr sound3_volume_register = 0x0400'0072;
+    constexpr uintptr sound3_frequency_register = 0x0400'0074;
+    constexpr uintptr sound4_envelope_register = 0x0400'0078;
+    constexpr uintptr sound4_frequency_register = 0x0400'007C;
+    constexpr uintptr sound_psg_control_register = 0x0400'0080;
+    constexpr uintptr sound_direct_control_register = 0x0400'0082;
+    constexpr uintptr sound_status_register = 0x0400'0084;
+    constexpr uintptr sound_wave_ram = 0x0400'0090;
+    constexpr uintptr sound_fifo_a = 0x0400'00A0;
+    constexpr uintptr sound_fifo_b = 0x0400'00A4;
+    constexpr uintptr dma_registers_base_address = 0x0400'00B0;
+    constexpr uintptr dma_register_increments = 0x000C;
+    constexpr uintptr timer_registers_base_address = 0x0400'0100;
+    constexpr uintptr timer_register_increments = 0x0004;
     constexpr uintptr key_input_register = 0x0400'0130;
     constexpr uintptr background_palettes = 0x0500'0000;
     constexpr uintptr object_palettes = 0x0500'0200;
@@ -18,6 +45,7 @@ namespace cgba
     constexpr uintptr vram = 0x0600'0000;
     constexpr uintptr screen_block_increments = 0x0800;
     constexpr uintptr character_block_increments = 0x4000;
+    constexpr uintptr object_vram = 0x0601'0000;
 
 
     template<class Ty>
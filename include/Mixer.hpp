@@ -0,0 +1,76 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Sections.hpp"
+#include <array>
+
+namespace cgba
+{
+    //Signed 8 bit mono PCM. Playback restarts at loopStart when it reaches length, samples without a loop have loopStart == length
+    struct SoundSample
+    {
+        const i8* data;
+        u32 length;
+        u32 sampleRate;
+        u32 loopStart;
+    };
+
+    //Mixes sound samples into signed 8 bit output at a fixed output rate, independent of the sound hardware so it also builds on the host.
+    //Samples are resampled by stepping through them in 20.12 fixed point and taking the nearest sample, channel volumes are in 64ths.
+    //A full volume channel comes out unchanged, louder sums are clipped
+    class Mixer
+    {
+    public:
+        static constexpr u32 maxChannels = 8;
+        static constexpr u32 maxVolume = 64;
+        static constexpr u32 maxSamplesPerMix = 1024;
+        static constexpr u32 noChannel = maxChannels;
+        static constexpr u32 fractionBits = 12;
+
+    private:
+        struct Channel
+        {
+            const i8* data = nullptr;
+            u32 position = 0;
+            u32 increment = 0;
+            u32 end = 0;
+            u32 loopLength = 0;
+            u32 volume = 0;
+        };
+
+        std::array<Channel, maxChannels> channels{};
+        u32 outputRate;
+
+        //Zeroed again while clipping, so it's always clear when a mix starts
+        alignas(4) std::array<i16, maxSamplesPerMix> accumulator{};
+
+    public:
+        explicit Mixer(u32 _outputRate);
+
+        //Starts the sample on a free channel and returns it, or noChannel when all of them are playing.
+        //A rate of 0 plays at the sample's own rate, other rates change the pitch
+        u32 Play(const SoundSample& sample, Range<u32, 0, maxVolume> volume = maxVolume, u32 rate = 0);
+        void Stop(Range<u32, 0, maxChannels - 1> channel);
+        void StopAll();
+
+        void SetVolume(Range<u32, 0, maxChannels - 1> channel, Range<u32, 0, maxVolume> volume);
+        void SetRate(Range<u32, 0, maxChannels - 1> channel, u32 rate);
+
+        WordBool IsPlaying(Range<u32, 0, maxChannels - 1> channel) const { return channels[channel].data != nullptr; }
+        u32 GetPlayingCount() const;
+        u32 GetOutputRate() const { return outputRate; }
+
+        //Writes count samples, a multiple of 4 up to maxSamplesPerMix, and advances every playing channel
+        void Mix(i8* output, u32 count);
+
+    private:
+        u32 GetIncrement(u32 rate) const;
+
+        //Adds count samples of the channel to the accumulator, or fewer when a sample without a loop ends first.
+        //Returns the number of samples added
+        CGBA_CODE_IWRAM static u32 MixChannel(Channel& channel, i16* accumulator, u32 count);
+
+        //Clips the accumulator to output and clears it
+        CGBA_CODE_IWRAM static void Resolve(i16* accumulator, i8* output, u32 count);
+    };
+}
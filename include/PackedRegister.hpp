@@ -1,6 +1,8 @@
 #pragma once
 #include <concepts>
 #include <climits>
+#include <bit>
+#include <type_traits>
 #include "Types.hpp"
 
 namespace cgba
@@ -11,6 +13,7 @@ namespace cgba
     struct PackedRegisterData
     {
         using type = IOType;
+        using mask_type = MaskType;
         static constexpr MaskType bitMask = (MaskSize == 1) ? 1 << MaskShift : ((1 << MaskSize) - 1) << MaskShift;
         static constexpr MaskType negatedBitMask = static_cast<MaskType>(~bitMask);
         static constexpr MaskType bitShift = MaskShift;
@@ -22,22 +25,23 @@ namespace cgba
             _register |= bitMask;
         }
         
+        //One read and one write, so a volatile register isn't read back between clearing the field and setting it
         template<std::integral RegisterTy>
             requires (sizeof(RegisterTy) == sizeof(MaskType))
         static constexpr void Set(RegisterTy& _register, IOType value)
         {
-            if constexpr(std::is_enum_v<IOType> && MaskSize == 1)
-            {
-                _register |= static_cast<std::underlying_type_t<IOType>>(value) << MaskShift;
-            }
+            _register = static_cast<MaskType>((_register & negatedBitMask) | Encode(value));
+        }
+
+        //The bits of value shifted into place, for combining with other fields before a single write
+        static constexpr MaskType Encode(IOType value)
+        {
+            if constexpr(std::is_enum_v<IOType>)
+                return static_cast<MaskType>((static_cast<std::underlying_type_t<IOType>>(value) << MaskShift) & bitMask);
+            else if constexpr(MaskSize == 1)
+                return static_cast<MaskType>(static_cast<u32>(value) != 0 ? bitMask : 0);
             else
-            {
-                Reset(_register);
-                if constexpr(std::is_enum_v<IOType>)
-                    _register |= static_cast<std::underlying_type_t<IOType>>(value) << MaskShift;
-                else
-                    _register |= value << MaskShift;
-            }
+                return static_cast<MaskType>((static_cast<u32>(value) << MaskShift) & bitMask);
         }
 
         template<std::integral RegisterTy>
@@ -64,4 +68,47 @@ namespace cgba
     
     template<class IOType, auto MaskSize, auto MaskShift>
     using u16PackedRegisterData = PackedRegisterData<u16, IOType, MaskSize, MaskShift>;
+
+    //Several fields of one register set together. Masks and shifts are merged at compile time, so setting every field costs
+    //a single read modify write, or a plain store when the fields cover the whole register
+    template<class... Fields>
+        requires (sizeof...(Fields) > 0)
+    struct PackedRegisterFields
+    {
+        using MaskType = std::common_type_t<typename Fields::mask_type...>;
+        static_assert((std::same_as<typename Fields::mask_type, MaskType> && ...), "Fields must belong to registers of the same size");
+
+        static constexpr MaskType bitMask = static_cast<MaskType>((Fields::bitMask | ...));
+        static constexpr MaskType negatedBitMask = static_cast<MaskType>(~bitMask);
+        static constexpr bool coversRegister = negatedBitMask == 0;
+        static_assert((std::popcount(Fields::bitMask) + ...) == std::popcount(bitMask), "Fields overlap");
+
+        static constexpr MaskType Pack(typename Fields::type... values)
+        {
+            return static_cast<MaskType>((Fields::Encode(values) | ...));
+        }
+
+        template<std::integral RegisterTy>
+            requires (sizeof(RegisterTy) == sizeof(MaskType))
+        static constexpr void Set(RegisterTy& _register, typename Fields::type... values)
+        {
+            if constexpr(coversRegister)
+                _register = Pack(values...);
+            else
+                _register = static_cast<MaskType>((_register & negatedBitMask) | Pack(values...));
+        }
+    };
+
+    static_assert([]
+    {
+        using Low = u16PackedRegisterData<u32, 4, 0>;
+        using Flag = u16PackedRegisterData<u32, 1, 4>;
+        using High = u16PackedRegisterData<u32, 11, 5>;
+
+        u16 partial = 0xFFFF;
+        PackedRegisterFields<Low, Flag>::Set(partial, 0x5, 0);
+        u16 full = 0xFFFF;
+        PackedRegisterFields<Low, Flag, High>::Set(full, 0x5, 1, 0x2);
+        return partial == 0xFFE5 && full == 0x0055 && PackedRegisterFields<Low, Flag, High>::coversRegister;
+    }());
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Sections.hpp"
+#include "VRAMFormats.hpp"
+#include <array>
+
+namespace cgba
+{
+    //Shadow copy of the 256 background and 256 object colors.
+    //Effects read the base colors and write the displayed ones, so fades can be recomputed every frame without drifting.
+    //Colors are stored two per word, which lets the blend work on both at once.
+    //Changed 16 color banks are tracked and uploaded by CommitVBlank
+    class PaletteEngine
+    {
+    public:
+        static constexpr u32 colorCount = 512;
+        static constexpr u32 colorsPerBank = 16;
+        static constexpr u32 objectFirstColor = 256;
+
+        //Blend weights have 5 fractional bits, maxWeight replaces the color entirely
+        static constexpr u32 maxWeight = 32;
+
+    private:
+        alignas(4) std::array<u32, colorCount / 2> base;
+        alignas(4) std::array<u32, colorCount / 2> output;
+        u32 dirtyBanks = 0;
+
+    public:
+        //Starts from the colors currently in palette RAM
+        PaletteEngine();
+
+        void SetColor(Range<u32, 0, colorCount - 1> index, RGB15 color);
+        RGB15 GetColor(Range<u32, 0, colorCount - 1> index) const;
+        RGB15 GetOutputColor(Range<u32, 0, colorCount - 1> index) const;
+
+        template<std::size_t Count>
+        void Load(const std::array<RGB15, Count>& colors, u32 firstIndex = 0)
+        {
+            CGBA_ASSERT(firstIndex + Count <= colorCount);
+            for(u32 i = 0; i < Count; i++)
+                SetColor(firstIndex + i, colors[i]);
+        }
+
+        //Displays count base colors moved weight / 32 of the way towards color, fading to black or white and tinting are all this
+        void Blend(u32 firstIndex, u32 count, RGB15 color, Range<u32, 0, maxWeight> weight);
+        void FadeToBlack(u32 firstIndex, u32 count, Range<u32, 0, maxWeight> weight) { Blend(firstIndex, count, RGB15{ 0, 0, 0 }, weight); }
+        void FadeToWhite(u32 firstIndex, u32 count, Range<u32, 0, maxWeight> weight) { Blend(firstIndex, count, RGB15{ 31, 31, 31 }, weight); }
+
+        //Displays the base colors again
+        void Restore(u32 firstIndex, u32 count);
+
+        //Rotates count base and displayed colors steps places towards higher indices, for water and lava style animations
+        void Cycle(u32 firstIndex, u32 count, u32 steps = 1);
+
+        //Copies the changed banks with DMA, call at the start of VBlank
+        void CommitVBlank();
+
+        WordBool IsDirty() const { return dirtyBanks != 0; }
+
+    private:
+        void MarkDirty(u32 firstIndex, u32 count);
+        static u16 GetHalf(const std::array<u32, colorCount / 2>& colors, u32 index);
+        static void SetHalf(std::array<u32, colorCount / 2>& colors, u32 index, u16 value);
+        CGBA_CODE_IWRAM static void BlendPairs(u32* destination, const u32* source, u32 pairCount, u32 pair, u32 weight);
+    };
+}
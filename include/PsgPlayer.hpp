@@ -0,0 +1,103 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include <array>
+
+namespace cgba
+{
+    //How a PSG channel plays its notes
+    struct PsgInstrument
+    {
+        //Bits 6 to 15 of SOUNDxCNT for the square and noise channels: duty, envelope step, direction and start volume
+        u16 envelope;
+        //SOUND1CNT_L for channel 1, for the noise channel bit 3 selects the 7 bit counter
+        u8 sweep;
+        //For the wave channel, the index of the wave in the song and the SOUND3CNT_H volume code in bits 5 to 7
+        u8 wave;
+    };
+
+    //Wave channel samples, 32 4 bit samples with the first one in the high nibble of the first byte
+    using PsgWave = std::array<u32, 4>;
+
+    //A song in the compact format written by tools/psg_converter.py.
+    //A pattern is its row count followed by the rows. A row is a byte whose low 4 bits flag the channels with a cell,
+    //then one cell per flagged channel: a note byte, noteOff or a note from C2 up to B7 (for the noise channel the divider ratio
+    //in bits 0 to 2 and the shift in bits 3 to 6), with bit 7 set when an instrument byte follows
+    struct PsgSong
+    {
+        static constexpr u8 noteOff = 0x7F;
+        static constexpr u8 instrumentFollows = 0x80;
+
+        const u8* const* patterns;
+        const u8* order;
+        u32 orderLength;
+        u32 loopOrder;
+        u32 ticksPerRow;
+        const PsgInstrument* instruments;
+        u32 instrumentCount;
+        const PsgWave* waves;
+        u32 waveCount;
+    };
+
+    //Plays a PsgSong on the 4 PSG channels. Tick is called once per frame and only decodes a row every ticksPerRow ticks.
+    //The last value written to every register is kept, so a row only writes the registers it changes and other ticks write nothing
+    class PsgPlayer
+    {
+    public:
+        static constexpr u32 channelCount = 4;
+
+    private:
+        enum class Slot : u32
+        {
+            Sweep1,
+            Envelope1,
+            Frequency1,
+            Envelope2,
+            Frequency2,
+            WaveEnable,
+            WaveVolume,
+            Frequency3,
+            Envelope4,
+            Frequency4,
+            Count
+        };
+
+        static constexpr u32 unknownValue = 0xFFFF'FFFF;
+
+        const PsgSong* song = nullptr;
+        u32 orderIndex = 0;
+        const u8* row = nullptr;
+        u32 rowsLeft = 0;
+        u32 tick = 0;
+
+        std::array<u8, channelCount> instruments{};
+        u32 loadedWave = unknownValue;
+        std::array<u32, static_cast<u32>(Slot::Count)> written{};
+        u32 writeCount = 0;
+
+    public:
+        //Turns the sound hardware and all PSG channels on, the first row plays on the next Tick
+        void Play(const PsgSong& _song);
+        void Stop();
+
+        //Call once per VBlank
+        void Tick();
+
+        WordBool IsPlaying() const { return song != nullptr; }
+
+        //Registers written by the last Tick
+        u32 GetWriteCount() const { return writeCount; }
+
+    private:
+        void StartPattern();
+        void PlayRow();
+        void PlayCell(u32 channel, u8 note, u32 instrument);
+        void Silence(u32 channel);
+        void LoadWave(u32 wave);
+
+        //Skips the store when the register already holds value, unless force is set for writes that restart a channel
+        void Write(Slot slot, u16 value, WordBool force = false);
+
+        static u16 GetFrequency(u8 note, u32 clock);
+    };
+}
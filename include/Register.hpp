@@ -0,0 +1,55 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "MemoryRegion.hpp"
+#include <type_traits>
+
+namespace cgba
+{
+    enum class RegisterAccess : u32
+    {
+        ReadWrite,
+        //Reads return open bus, so the register can only be stored to
+        WriteOnly
+    };
+
+    //Explicit accesses to memory mapped registers, Value is the non volatile register type (e.g. DisplayControlRegister).
+    //Load is the only read and Store the only write, so a value is changed freely in between and updating any number of
+    //fields through Modify costs exactly one read and one write. Count registers of the same kind are Stride bytes apart
+    template<class Value, uintptr Address, RegisterAccess Access = RegisterAccess::ReadWrite, u32 Count = 1, uintptr Stride = sizeof(Value)>
+    struct IORegister
+    {
+        using value_type = Value;
+        using data_type = std::remove_cv_t<decltype(Value::data)>;
+        static_assert(sizeof(data_type) == sizeof(Value), "Register values hold nothing but their data");
+
+        static constexpr u32 count = Count;
+
+        static uintptr GetAddress(Range<u32, 0, Count - 1> index = 0)
+        {
+            return Address + index * Stride;
+        }
+
+        static Value Load(Range<u32, 0, Count - 1> index = 0) requires (Access == RegisterAccess::ReadWrite)
+        {
+            Value value{};
+            value.data = Memory<volatile data_type>(GetAddress(index));
+            return value;
+        }
+
+        static void Store(const Value& value, Range<u32, 0, Count - 1> index = 0)
+        {
+            Memory<volatile data_type>(GetAddress(index)) = value.data;
+        }
+
+        //modify is called with the loaded value, which is then stored back and returned
+        template<class Function>
+        static Value Modify(Function&& modify, Range<u32, 0, Count - 1> index = 0) requires (Access == RegisterAccess::ReadWrite)
+        {
+            Value value = Load(index);
+            modify(value);
+            Store(value, index);
+            return value;
+        }
+    };
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Sections.hpp"
+#include "VRAMFormats.hpp"
+#include <array>
+
+namespace cgba
+{
+    enum class RenderCommandType : u8
+    {
+        //width halfwords from the buffer's value pool
+        Write,
+        Fill,
+        Copy
+    };
+
+    //Rows of Fill and Copy commands are a screen block row apart
+    struct RenderCommand
+    {
+        RenderCommandType type;
+        u8 width;
+        u8 height;
+        u8 sourceStride;
+        volatile u16* destination;
+        const u16* source;
+        u16 value;
+    };
+
+    //Tile map and palette edits recorded during the frame and written out in VBlank, so the PPU never shows half of a change.
+    //Writes that continue the previous write, and fills next to a fill of the same entry, are merged into one command.
+    //Edits that don't fit are dropped and counted, flushing them early would show outside of VBlank
+    class RenderCommandBuffer
+    {
+    public:
+        static constexpr u32 maxCommands = 64;
+        static constexpr u32 maxValues = 128;
+
+    private:
+        std::array<RenderCommand, maxCommands> commands;
+        alignas(4) std::array<u16, maxValues> values;
+        u32 commandCount = 0;
+        u32 valueCount = 0;
+        u32 droppedCount = 0;
+
+    public:
+        //Positions are in tiles within one 32x32 screen block
+        void SetTile(Range<u32, 0, 31> screenBaseBlock, Point<i16> position, TextBackgroundTileDescription tile);
+        void FillRect(Range<u32, 0, 31> screenBaseBlock, Point<i16> position, Rectangle size, TextBackgroundTileDescription tile);
+
+        //source has to stay valid until the flush, sourceStride is in entries
+        void CopyRect(Range<u32, 0, 31> screenBaseBlock, Point<i16> position, Rectangle size, const TextBackgroundTileDescription* source, u32 sourceStride);
+
+        //Indices from 256 are object colors
+        void SetColor(Range<u32, 0, 511> index, RGB15 color);
+
+        //Call right after VBlank starts
+        CGBA_CODE_IWRAM void Flush();
+
+        void Clear();
+        u32 GetCommandCount() const { return commandCount; }
+        WordBool IsEmpty() const { return commandCount == 0; }
+
+        //Edits dropped since the last Flush or Clear because the buffer was full
+        u32 GetDroppedCount() const { return droppedCount; }
+
+    private:
+        void Write(volatile u16* destination, u16 value);
+        WordBool Add(const RenderCommand& command);
+        static volatile u16* GetEntryAddress(u32 screenBaseBlock, Point<i16> position);
+    };
+}
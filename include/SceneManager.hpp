@@ -0,0 +1,140 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "Display.hpp"
+#include "Input.hpp"
+#include "AssetLoader.hpp"
+#include "VramAllocator.hpp"
+#include "PaletteEngine.hpp"
+#include "FramePipeline.hpp"
+#include "Coroutine.hpp"
+#include "DirectSound.hpp"
+#include "PsgPlayer.hpp"
+#include <array>
+
+namespace cgba
+{
+    //Shadow copy of the registers a scene switch changes, written in one go during VBlank so no frame shows half of each scene.
+    //The scroll registers are write only, so the last values written are kept here instead of being read back
+    struct DisplayState
+    {
+        static constexpr u32 backgroundCount = 4;
+
+        DisplayControlRegister control{};
+        std::array<BackgroundControlRegister, backgroundCount> backgrounds{};
+        std::array<Point<u16>, backgroundCount> scroll{};
+
+        //Reads the current display and background control registers, leaving scroll as is
+        void CaptureControl();
+
+        //Call during VBlank
+        void Apply() const;
+    };
+
+    //Systems shared by every scene, one frame of the manager updates and commits all of them
+    struct SceneContext
+    {
+        VramAllocator& vram;
+        AssetLoader& loader;
+        PaletteEngine& palette;
+        FramePipeline& pipeline;
+        InputLatch& inputLatch;
+        BasicController& controller;
+        TaskScheduler& tasks;
+        DirectSound& sound;
+        PsgPlayer& music;
+    };
+
+    class SceneManager;
+
+    //Hooks of a scene, called by SceneManager in this order on a switch:
+    //Preload on the frame the switch is requested, Enter (or Resume) once the asset loader is idle,
+    //then at the next VBlank the new registers are applied and the previous scene gets Exit (or Suspend)
+    class Scene
+    {
+    protected:
+        SceneContext& context;
+
+    public:
+        explicit Scene(SceneContext& _context) :
+            context{ _context }
+        {
+
+        }
+
+        Scene(const Scene&) = delete;
+        Scene& operator=(const Scene&) = delete;
+        virtual ~Scene() = default;
+
+        //The previous scene is still displayed and updating, allocate VRAM and queue asset loads without touching what it uses
+        virtual void Preload() {}
+
+        //Still before the switch, fill VRAM that isn't displayed yet and set the layers up in display
+        virtual void Enter(DisplayState& /*display*/) {}
+
+        //Called during the VBlank of the switch, after the next scene's registers are live
+        virtual void Exit() {}
+
+        //Another scene was pushed on top, called during the VBlank of the switch
+        virtual void Suspend() {}
+
+        //The scene on top was popped, called before the switch like Enter
+        virtual void Resume(DisplayState& /*display*/) {}
+
+        //Once per frame between input sampling and VBlank, only for the scene on top
+        virtual void Update(SceneManager& scenes) = 0;
+
+        //Right after VBlank starts, only for the scene on top
+        virtual void CommitVBlank() {}
+    };
+
+    //Stack of scenes where only the top one runs. Switches are requested from Update and happen a few frames later,
+    //the current scene keeps running while the next one streams its assets into free VRAM, then both swap in one VBlank
+    class SceneManager
+    {
+    public:
+        static constexpr u32 maxDepth = 4;
+
+    private:
+        enum class Transition : u32
+        {
+            None,
+            Push,
+            Replace,
+            Pop
+        };
+
+        SceneContext& context;
+        std::array<Scene*, maxDepth> stack{};
+        u32 depth = 0;
+
+        Transition transition = Transition::None;
+        Scene* next = nullptr;
+        WordBool entered = false;
+
+        DisplayState live;
+        DisplayState pending;
+
+    public:
+        explicit SceneManager(SceneContext& _context);
+
+        //Pushes the first scene and runs frames forever
+        [[noreturn]] void Run(Scene& first);
+        void RunFrame();
+
+        //Only one switch can be in flight, requests made during a switch return false.
+        //So do pushes onto a full stack, replacing with no scene on the stack and popping the last scene
+        WordBool Push(Scene& scene);
+        WordBool Replace(Scene& scene);
+        WordBool Pop();
+
+        WordBool IsSwitching() const { return transition != Transition::None; }
+        Scene* GetTop() const { return depth > 0 ? stack[depth - 1] : nullptr; }
+        u32 GetDepth() const { return depth; }
+
+    private:
+        WordBool Request(Transition _transition, Scene* scene);
+        void PrepareSwitch();
+        void SwitchVBlank();
+    };
+}
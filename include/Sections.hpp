@@ -0,0 +1,27 @@
+#pragma once
+
+//Placement of code and data in the GBA memory regions, the section names are the ones the devkitARM linker script maps.
+//IWRAM is 32KB with a 32 bit bus and no wait states, EWRAM is 256KB with a 16 bit bus and 2 wait states.
+//Globals without an attribute end up in IWRAM, which also holds the stack
+
+#if defined(__arm__)
+    //Functions also need to be compiled as ARM, which is done for *.bn_iwram.cpp files
+    #define CGBA_CODE_IWRAM __attribute__((section(".iwram"), long_call))
+    #define CGBA_CODE_EWRAM __attribute__((section(".ewram"), long_call))
+
+    //Initialized data is copied from ROM at startup
+    #define CGBA_DATA_IWRAM __attribute__((section(".iwram")))
+    #define CGBA_DATA_EWRAM __attribute__((section(".ewram")))
+
+    //Zero initialized, nothing is stored in ROM for these
+    #define CGBA_BSS_IWRAM __attribute__((section(".bss")))
+    #define CGBA_BSS_EWRAM __attribute__((section(".sbss")))
+#else
+    //Host builds of the hardware independent code, e.g. for benchmarks, have a single kind of memory
+    #define CGBA_CODE_IWRAM
+    #define CGBA_CODE_EWRAM
+    #define CGBA_DATA_IWRAM
+    #define CGBA_DATA_EWRAM
+    #define CGBA_BSS_IWRAM
+    #define CGBA_BSS_EWRAM
+#endif
@@ -1,9 +1,30 @@
 #pragma once
 #include "Math.hpp"
 #include "Display.hpp"
+#include "SceneManager.hpp"
+#include "Blend.hpp"
+#include "Arena.hpp"
+#include "FixedTimestep.hpp"
+#include "Text.hpp"
+#include "RenderCommands.hpp"
 #include <array>
+#include <optional>
 
-void SnakeScene();
+//Tile order of graphics/cgba/snake_tiles.bmp
+struct SnakeTiles
+{
+    static constexpr cgba::u32 empty = 0;
+    static constexpr cgba::u32 snake = 1;
+    static constexpr cgba::u32 apple = 2;
+};
+
+using SnakeScreenBlockView = cgba::StaticTextScreenBlockView<cgba::TextScreenSizeMode::W256_H256>;
+
+//Shares the snake tiles between scenes, queuing the copy only for the first one that asks for them
+cgba::VramHandle AcquireSnakeTiles(cgba::SceneContext& context);
+
+//Points a 256 color, 256x256 text background at a screen block, with its tiles in character block 0
+void SetUpSnakeBackground(cgba::BackgroundControlRegister& background, cgba::u32 screenBaseBlock, cgba::u32 priority);
 
 struct Snake
 {
@@ -15,6 +36,11 @@ struct Snake
 struct SnakeDirectionBoard
 {
     static constexpr cgba::Rectangle boardSize = cgba::ElementWiseDiv(cgba::Display::hardwareScreenSizePixels, cgba::tileSizePixels);
+
+    //Rows above it are covered by the HUD, so the snake and apples stay below
+    static constexpr cgba::i16 firstPlayableRow = 1;
+    static constexpr cgba::u32 playableCells = boardSize.width * (boardSize.height - firstPlayableRow);
+
     cgba::u32 occupiedSpaceCount;
     std::array<cgba::Point<cgba::i16>, cgba::Area(boardSize)> board = {};
 
@@ -29,10 +55,127 @@ struct SnakeDirectionBoard
     }
 };
 
+//Turns pressed between two moves, each one checked against the turn queued before it so quick double turns aren't lost
+struct SnakeDirectionQueue
+{
+    static constexpr cgba::u32 capacity = 3;
+
+    std::array<cgba::Point<cgba::i16>, capacity> directions = {};
+    cgba::u32 first = 0;
+    cgba::u32 count = 0;
+
+    //Drops turns onto the same axis as the previous direction, and any turn once the queue is full
+    cgba::WordBool Push(cgba::Point<cgba::i16> direction, cgba::Point<cgba::i16> currentDirection)
+    {
+        const cgba::Point<cgba::i16> previous = count > 0 ? directions[(first + count - 1) % capacity] : currentDirection;
+        const cgba::WordBool perpendicular = (previous.x != 0 && direction.y != 0) || (previous.y != 0 && direction.x != 0);
+        if(!perpendicular || count == capacity)
+            return false;
+
+        directions[(first + count) % capacity] = direction;
+        count++;
+        return true;
+    }
+
+    cgba::WordBool Pop(cgba::Point<cgba::i16>& direction)
+    {
+        if(count == 0)
+            return false;
+
+        direction = directions[first];
+        first = (first + 1) % capacity;
+        count--;
+        return true;
+    }
+};
+
 struct SnakeGameState
 {
     cgba::Point<cgba::i16> applePosition;
     cgba::Point<cgba::i16> snakeMovementDirection{ 1, 0 };
     Snake snake;
+    SnakeDirectionQueue directionQueue;
     SnakeDirectionBoard board;
+};
+
+//Score and snake length along the top row on a 16 color layer, only changed values are formatted and only changed tiles written
+class SnakeHud
+{
+public:
+    static constexpr cgba::u32 glyphSlots = 20;
+    static constexpr cgba::u32 lengthTiles = 8;
+
+    //A blank tile, the glyph cache slots, then the tiles of the length label
+    static constexpr cgba::u32 tileCount = 1 + glyphSlots + lengthTiles;
+    static constexpr cgba::u32 paletteNumber = 15;
+
+private:
+    cgba::GlyphCache glyphs;
+    cgba::TextLabel scoreCaption;
+    cgba::TextLabel score;
+    cgba::ProportionalTextLabel length;
+    cgba::u32 shownScore = 0xFFFF'FFFF;
+    cgba::u32 shownLength = 0xFFFF'FFFF;
+
+public:
+    //Clears the screen block, call before it's displayed
+    SnakeHud(cgba::u32 characterBlock, cgba::u32 firstTile, cgba::u32 screenBaseBlock);
+
+    void Update(cgba::u32 applesEaten, cgba::u32 snakeLength);
+    void CommitVBlank();
+};
+
+//Dims the board that is still displayed below it, A starts a new round
+class GameOverScene : public cgba::Scene
+{
+private:
+    cgba::ScreenFade fade;
+
+public:
+    using cgba::Scene::Scene;
+
+    void Enter(cgba::DisplayState& display) override;
+    void Exit() override;
+    void Update(cgba::SceneManager& scenes) override;
+    void CommitVBlank() override;
+};
+
+class SnakeScene : public cgba::Scene
+{
+public:
+    static constexpr cgba::u32 maxMovesPerFrame = 4;
+
+private:
+    GameOverScene& gameOver;
+    cgba::VramHandle tiles;
+    cgba::VramHandle snakeMap;
+    cgba::VramHandle appleMap;
+
+    //The board is touched every move, it's kept in IWRAM while the scene is on the stack
+    std::optional<cgba::ScopedArenaReset> stateMemory;
+    SnakeGameState* state = nullptr;
+
+    cgba::FixedTimestep moveTimestep;
+    cgba::u32 lastFrameTime = 0;
+    cgba::WordBool playing = false;
+    cgba::RenderCommandBuffer renderCommands;
+
+    cgba::VramHandle hudTiles;
+    cgba::VramHandle hudMap;
+    std::optional<SnakeHud> hud;
+
+public:
+    SnakeScene(cgba::SceneContext& _context, GameOverScene& _gameOver);
+
+    void Preload() override;
+    void Enter(cgba::DisplayState& display) override;
+    void Exit() override;
+    void Resume(cgba::DisplayState& display) override;
+    void Update(cgba::SceneManager& scenes) override;
+    void CommitVBlank() override;
+
+private:
+    void StartRound();
+    cgba::u32 GetSnakeScreenBlock() const { return context.vram.GetScreenBaseBlock(snakeMap); }
+    cgba::u32 GetAppleScreenBlock() const { return context.vram.GetScreenBaseBlock(appleMap); }
 };
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#include "Types.hpp"
+#include "MemoryRegion.hpp"
+#include "Math.hpp"
+#include "PackedRegister.hpp"
+#include "Register.hpp"
+
+namespace cgba
+{
+    enum class SoundFifo : u32
+    {
+        A = 0,
+        B = 1
+    };
+
+    //How loud the 4 PSG channels are mixed next to DirectSound
+    enum class PsgMixVolume : u32
+    {
+        Quarter = 0,
+        Half = 1,
+        Full = 2
+    };
+
+    enum class DirectSoundVolume : u32
+    {
+        Half = 0,
+        Full = 1
+    };
+
+    //SOUNDCNT_L, master volumes and which PSG channels play on each side
+    struct PsgControlRegister
+    {
+        using Right_Volume = u16PackedRegisterData<Range<u32, 0, 7>, 3, 0>;
+        using Left_Volume = u16PackedRegisterData<Range<u32, 0, 7>, 3, 4>;
+        using Right_Channels = u16PackedRegisterData<u32, 4, 8>;
+        using Left_Channels = u16PackedRegisterData<u32, 4, 12>;
+
+        static constexpr u32 allChannels = (1 << 4) - 1;
+
+        u16 data = 0;
+
+        void SetVolume(Left_Volume::type left, Right_Volume::type right)
+        {
+            PackedRegisterFields<Left_Volume, Right_Volume>::Set(data, left, right);
+        }
+
+        //Bit n of the masks is PSG channel n
+        void SetChannels(Left_Channels::type left, Right_Channels::type right)
+        {
+            PackedRegisterFields<Left_Channels, Right_Channels>::Set(data, left, right);
+        }
+    };
+
+    //SOUNDCNT_H, FIFO B's fields are FIFO A's moved up by fifoFieldShift
+    struct DirectSoundControlRegister
+    {
+        using Psg_Volume = u16PackedRegisterData<PsgMixVolume, 2, 0>;
+        using Fifo_A_Volume = u16PackedRegisterData<DirectSoundVolume, 1, 2>;
+        using Fifo_B_Volume = u16PackedRegisterData<DirectSoundVolume, 1, 3>;
+        using Fifo_A_Right = u16PackedRegisterData<WordBool, 1, 8>;
+        using Fifo_A_Left = u16PackedRegisterData<WordBool, 1, 9>;
+        using Fifo_A_Timer = u16PackedRegisterData<Range<u32, 0, 1>, 1, 10>;
+        using Fifo_A_Reset = u16PackedRegisterData<WordBool, 1, 11>;
+
+        static constexpr u32 fifoFieldShift = 4;
+
+        u16 data = 0;
+
+        void SetPsgVolume(Psg_Volume::type value)
+        {
+            Psg_Volume::Set(data, value);
+        }
+
+        Psg_Volume::type GetPsgVolume() const
+        {
+            return Psg_Volume::Get(data);
+        }
+
+        void SetFifoVolume(SoundFifo fifo, DirectSoundVolume value)
+        {
+            if(fifo == SoundFifo::A)
+                Fifo_A_Volume::Set(data, value);
+            else
+                Fifo_B_Volume::Set(data, value);
+        }
+
+        //Which speakers the FIFO plays on and which of timer 0 and 1 pops its samples
+        void SetFifoOutput(SoundFifo fifo, WordBool left, WordBool right, Fifo_A_Timer::type timer)
+        {
+            const u32 shift = static_cast<u32>(fifo) * fifoFieldShift;
+            const u16 fields = PackedRegisterFields<Fifo_A_Right, Fifo_A_Left, Fifo_A_Timer>::Pack(right, left, timer);
+            const u16 mask = PackedRegisterFields<Fifo_A_Right, Fifo_A_Left, Fifo_A_Timer>::bitMask;
+            data = static_cast<u16>((data & ~(mask << shift)) | (fields << shift));
+        }
+
+        void DisableFifo(SoundFifo fifo)
+        {
+            SetFifoOutput(fifo, false, false, 0);
+        }
+
+        //Empties the FIFO when written, the bit doesn't stay set
+        void ResetFifo(SoundFifo fifo)
+        {
+            data |= static_cast<u16>(Fifo_A_Reset::bitMask << (static_cast<u32>(fifo) * fifoFieldShift));
+        }
+    };
+
+    //SOUNDCNT_X, the other sound registers ignore writes while the master enable is off
+    struct SoundStatusRegister
+    {
+        using Psg_Channel_Playing = u16PackedRegisterData<u32, 4, 0>;
+        using Master_Enable = u16PackedRegisterData<WordBool, 1, 7>;
+
+        u16 data = 0;
+
+        void Enable()
+        {
+            Master_Enable::Set(data);
+        }
+
+        void Disable()
+        {
+            Master_Enable::Reset(data);
+        }
+
+        Master_Enable::type IsEnabled() const
+        {
+            return Master_Enable::Get(data);
+        }
+
+        //Read only, channels 0 to 3 are the two squares, the wave and the noise channel
+        WordBool IsPsgChannelPlaying(Range<u32, 0, 3> channel) const
+        {
+            return (Psg_Channel_Playing::Get(data) >> channel) & 1;
+        }
+    };
+
+    static_assert(sizeof(PsgControlRegister) == 2);
+    static_assert(sizeof(DirectSoundControlRegister) == 2);
+    static_assert(sizeof(SoundStatusRegister) == 2);
+
+    using PsgControl = IORegister<PsgControlRegister, sound_psg_control_register>;
+    using DirectSoundControl = IORegister<DirectSoundControlRegister, sound_direct_control_register>;
+    using SoundStatus = IORegister<SoundStatusRegister, sound_status_register>;
+
+    struct Sound
+    {
+        //Turns the sound hardware on, which has to happen before any other sound register is written
+        static void Enable()
+        {
+            SoundStatus::Modify([](SoundStatusRegister& status){ status.Enable(); });
+        }
+
+        static uintptr GetFifoAddress(SoundFifo fifo)
+        {
+            return fifo == SoundFifo::A ? sound_fifo_a : sound_fifo_b;
+        }
+
+        //DMA 1 feeds FIFO A and DMA 2 FIFO B when started with the special timing
+        static u32 GetFifoDmaChannel(SoundFifo fifo)
+        {
+            return fifo == SoundFifo::A ? 1 : 2;
+        }
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "VRAMFormats.hpp"
+#include "VramAllocator.hpp"
+
+namespace cgba
+{
+    //Every frame of a sprite in ROM, frame n is tilesPerFrame tiles starting tilesPerFrame * n tiles into tiles
+    struct AnimationSheet
+    {
+        const void* tiles;
+        u32 tilesPerFrame;
+        PaletteMode mode;
+    };
+
+    //A sequence of sheet frames played at rate frames per Update, e.g. FromFraction(1, 6) shows each frame for 6 updates
+    struct AnimationClip
+    {
+        using Rate = Fixed<u32, 8>;
+
+        const u16* frames;
+        u32 frameCount;
+        Rate rate;
+        WordBool loop;
+    };
+
+    //Plays clips of a sheet into a VRAM slot holding a single frame, so a sprite can have more frames than object VRAM could hold.
+    //Update advances the clip during the frame and CommitVBlank copies the new frame's tiles with DMA only when the frame changed.
+    //The slot's tile number doesn't change while it's allocated, object attributes use GetFirstTile
+    class SpriteAnimation
+    {
+    public:
+        using Rate = AnimationClip::Rate;
+
+    private:
+        static constexpr u32 noFrame = 0xFFFF'FFFF;
+
+        const AnimationSheet* sheet = nullptr;
+        VramHandle slot;
+        volatile void* slotAddress = nullptr;
+        u32 firstTile = 0;
+
+        const AnimationClip* clip = nullptr;
+        Rate position{};
+        Rate speed = Rate::FromInt(1);
+        WordBool finished = false;
+        u32 uploadedFrame = noFrame;
+
+    public:
+        //Returns false when object VRAM has no room for one frame of the sheet
+        WordBool Allocate(VramAllocator& vram, const AnimationSheet& _sheet);
+        void Release(VramAllocator& vram);
+        WordBool IsAllocated() const { return slot.IsValid(); }
+
+        //Starts the clip from its first frame, playing the clip that is already playing only restarts it when restart is set
+        void Play(const AnimationClip& _clip, WordBool restart = false);
+        void Stop();
+
+        //Multiplies the rate of every clip, 1 plays them as authored
+        void SetSpeed(Rate _speed) { speed = _speed; }
+        Rate GetSpeed() const { return speed; }
+
+        //Call once per frame
+        void Update();
+
+        //Call during VBlank, copies at most one frame of tiles
+        void CommitVBlank();
+
+        //Stays false for looping clips, a clip that doesn't loop holds its last frame once finished
+        WordBool IsFinished() const { return finished; }
+        const AnimationClip* GetClip() const { return clip; }
+        u32 GetClipFrame() const { return position.ToInt(); }
+        u32 GetFirstTile() const { return firstTile; }
+    };
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "VRAMFormats.hpp"
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace cgba
+{
+    //One 16 color 8x8 tile per character for a contiguous range of ASCII, usually from a font sheet made by tile_converter.py.
+    //Advance widths for proportional text are measured from the glyph pixels, the rightmost used column plus letterSpacing
+    class TileFont
+    {
+    public:
+        static constexpr u32 maxGlyphs = 96;
+
+    private:
+        const CharacterTile16* glyphs;
+        u32 glyphCount;
+        char firstCharacter;
+        u32 fallbackGlyph;
+        std::array<u8, maxGlyphs> widths;
+
+    public:
+        template<std::size_t Count>
+        constexpr TileFont(const std::array<CharacterTile16, Count>& _glyphs, char _firstCharacter = ' ', char fallback = '?', u32 letterSpacing = 0, u32 spaceWidth = 4) :
+            glyphs{ _glyphs.data() },
+            glyphCount{ Count },
+            firstCharacter{ _firstCharacter },
+            fallbackGlyph{ 0 },
+            widths{}
+        {
+            static_assert(Count <= maxGlyphs);
+            if(fallback >= firstCharacter && static_cast<u32>(fallback - firstCharacter) < glyphCount)
+                fallbackGlyph = static_cast<u32>(fallback - firstCharacter);
+
+            for(u32 glyph = 0; glyph < glyphCount; glyph++)
+            {
+                u32 width = 0;
+                for(u32 pixel = 0; pixel < Area(tileSizePixels); pixel++)
+                {
+                    if(glyphs[glyph].GetPixel(pixel) != 0)
+                        width = std::max<u32>(width, pixel % tileSizePixels.width + 1);
+                }
+                widths[glyph] = static_cast<u8>(width == 0 ? spaceWidth : width + letterSpacing);
+            }
+        }
+
+        //Characters outside the font use the fallback glyph
+        u32 GetGlyphIndex(char character) const
+        {
+            const u32 index = static_cast<u32>(static_cast<u8>(character) - static_cast<u8>(firstCharacter));
+            return index < glyphCount ? index : fallbackGlyph;
+        }
+
+        const CharacterTile16& GetGlyph(u32 index) const { return glyphs[index]; }
+        u32 GetWidth(u32 index) const { return widths[index]; }
+        u32 GetGlyphCount() const { return glyphCount; }
+        u32 MeasureWidth(std::string_view text) const;
+    };
+
+    //Writes value in decimal, padded with zeros to minDigits, and returns the number of characters written
+    u32 FormatDecimal(u32 value, char* buffer, u32 bufferSize, u32 minDigits = 1);
+
+    //Keeps recently used glyphs in a range of character tiles, so fixed width text only has to write screen entries.
+    //Glyphs still shown somewhere are never evicted, a miss reuses the least recently used slot that isn't
+    class GlyphCache
+    {
+    public:
+        static constexpr u32 maxSlots = 64;
+
+    private:
+        static constexpr u8 noSlot = 0xFF;
+        static constexpr u8 noGlyph = 0xFF;
+
+        const TileFont& font;
+        CharacterBlockView16 block;
+        u32 firstTile;
+        u32 slotCount;
+
+        std::array<u8, TileFont::maxGlyphs> glyphSlots;
+        std::array<u8, maxSlots> slotGlyphs;
+        std::array<u16, maxSlots> useCounts;
+        std::array<u32, maxSlots> lastUsed;
+        u32 clock = 0;
+        u32 misses = 0;
+
+    public:
+        //The slots are tiles firstTile to firstTile + slotCount - 1 of the character block
+        GlyphCache(const TileFont& _font, Range<u32, 0, 3> characterBlock, u32 _firstTile, Range<u32, 1, maxSlots> _slotCount);
+
+        //Returns the tile number holding the glyph, a miss copies the glyph into VRAM so call during VBlank
+        u32 Acquire(char character);
+        void Release(char character);
+
+        const TileFont& GetFont() const { return font; }
+        u32 GetMissCount() const { return misses; }
+    };
+
+    //Fixed width text on one row of a screen block, one tile per character.
+    //Set only records the text, CommitVBlank rewrites the cells that differ from what's displayed
+    class TextLabel
+    {
+    public:
+        static constexpr u32 maxLength = 32;
+
+    private:
+        GlyphCache& cache;
+        TextScreenBlockView screen;
+        Point<i16> position;
+        u32 length;
+        u32 paletteNumber;
+
+        //'\0' marks a cell that was never written
+        std::array<char, maxLength> text{};
+        std::array<char, maxLength> shown{};
+        WordBool dirty = false;
+
+    public:
+        //Text is padded with spaces to length characters, longer text is cut
+        TextLabel(GlyphCache& _cache, Range<u32, 0, 31> screenBaseBlock, Point<i16> _position, Range<u32, 1, maxLength> _length, Range<u32, 0, 15> _paletteNumber);
+        ~TextLabel();
+
+        void Set(std::string_view value);
+        void SetNumber(u32 value, u32 minDigits = 1);
+        void CommitVBlank();
+    };
+
+    //Proportional text drawn into tiles owned by the label, whose screen entries are written once.
+    //Glyphs after a changed character move with it, so tiles are redrawn from the one holding the first difference
+    class ProportionalTextLabel
+    {
+    public:
+        static constexpr u32 maxTiles = 16;
+        static constexpr u32 maxLength = 32;
+
+    private:
+        const TileFont& font;
+        CharacterBlockView16 block;
+        u32 firstTile;
+        u32 tileCount;
+
+        //Rows of 8 pixels packed as in VRAM, drawn here and copied out tile by tile
+        alignas(4) std::array<std::array<u32, tileSizePixels.height>, maxTiles> pixels{};
+
+        std::array<char, maxLength> text{};
+        u32 length = 0;
+        u32 firstChanged = 0;
+        u32 drawnTiles = 0;
+        WordBool dirty = false;
+
+    public:
+        //Writes the screen entries for tiles firstTile to firstTile + tileCount - 1 of the character block straight away
+        ProportionalTextLabel(const TileFont& _font, Range<u32, 0, 3> characterBlock, u32 _firstTile, Range<u32, 1, maxTiles> _tileCount,
+            Range<u32, 0, 31> screenBaseBlock, Point<i16> position, Range<u32, 0, 15> paletteNumber);
+
+        void Set(std::string_view value);
+        void SetNumber(u32 value, u32 minDigits = 1);
+        void CommitVBlank();
+
+    private:
+        void DrawGlyph(u32 glyph, u32 x);
+    };
+}
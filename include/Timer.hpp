@@ -0,0 +1,160 @@
+#pragma once
+#include "Types.hpp"
+#include "MemoryRegion.hpp"
+#include "Math.hpp"
+#include "PackedRegister.hpp"
+#include <utility>
+
+namespace cgba
+{
+    enum class TimerPrescaler : u32
+    {
+        Cycles1 = 0,
+        Cycles64 = 1,
+        Cycles256 = 2,
+        Cycles1024 = 3
+    };
+
+    template<bool Volatile>
+    struct TimerControlRegisterTemplate
+    {
+        using Prescaler = u16PackedRegisterData<TimerPrescaler, 2, 0>;
+        using Count_Up_Timing = u16PackedRegisterData<WordBool, 1, 2>;
+        using Enable_IRQ = u16PackedRegisterData<WordBool, 1, 6>;
+        using Enable = u16PackedRegisterData<WordBool, 1, 7>;
+
+        ConditionallyVolatile_T<u16, Volatile> data;
+
+        TimerControlRegisterTemplate() = default;
+        TimerControlRegisterTemplate(const TimerControlRegisterTemplate<!Volatile>& other) :
+            data{ other.data }
+        {
+
+        }
+
+        TimerControlRegisterTemplate& operator=(const TimerControlRegisterTemplate& other) = default;
+        TimerControlRegisterTemplate& operator=(const TimerControlRegisterTemplate<!Volatile>& other)
+        {
+            data = other.data;
+            return *this;
+        }
+
+        void SetPrescaler(Prescaler::type value)
+        {
+            Prescaler::Set(data, value);
+        }
+
+        Prescaler::type GetPrescaler() const
+        {
+            return Prescaler::Get(data);
+        }
+
+        //Increments when the previous timer overflows instead of following the prescaler
+        void EnableCountUpTiming()
+        {
+            Count_Up_Timing::Set(data);
+        }
+
+        void DisableCountUpTiming()
+        {
+            Count_Up_Timing::Reset(data);
+        }
+
+        void EnableIRQ()
+        {
+            Enable_IRQ::Set(data);
+        }
+
+        void DisableIRQ()
+        {
+            Enable_IRQ::Reset(data);
+        }
+
+        void Start()
+        {
+            Enable::Set(data);
+        }
+
+        void Stop()
+        {
+            Enable::Reset(data);
+        }
+
+        Enable::type IsRunning() const
+        {
+            return Enable::Get(data);
+        }
+    };
+
+    using TimerControlRegister = TimerControlRegisterTemplate<false>;
+    using VolatileTimerControlRegister = TimerControlRegisterTemplate<true>;
+
+    static_assert(sizeof(TimerControlRegister) == 2);
+
+    struct Timer
+    {
+        //Reading gives the current count, writing sets the value loaded on start and on overflow
+        static volatile u16& GetCounter(Range<u32, 0, 3> timer)
+        {
+            return Memory<volatile u16>(timer_registers_base_address + timer_register_increments * timer);
+        }
+
+        static VolatileTimerControlRegister& GetControlRegister(Range<u32, 0, 3> timer)
+        {
+            return Memory<VolatileTimerControlRegister>(timer_registers_base_address + timer_register_increments * timer + sizeof(u16));
+        }
+    };
+
+    //Counts CPU cycles with two cascaded timers, LowTimer and the one after it
+    template<u32 LowTimer = 2>
+        requires (LowTimer < 3)
+    class CycleCounter
+    {
+    public:
+        void Start()
+        {
+            Timer::GetControlRegister(LowTimer) = TimerControlRegister{};
+            Timer::GetControlRegister(LowTimer + 1) = TimerControlRegister{};
+            Timer::GetCounter(LowTimer) = 0;
+            Timer::GetCounter(LowTimer + 1) = 0;
+
+            TimerControlRegister high{};
+            high.EnableCountUpTiming();
+            high.Start();
+            Timer::GetControlRegister(LowTimer + 1) = high;
+
+            TimerControlRegister low{};
+            low.SetPrescaler(TimerPrescaler::Cycles1);
+            low.Start();
+            Timer::GetControlRegister(LowTimer) = low;
+        }
+
+        //Can be read while running, the high counter is read twice in case the low one overflows in between
+        u32 GetElapsed() const
+        {
+            const u32 high = Timer::GetCounter(LowTimer + 1);
+            const u32 low = Timer::GetCounter(LowTimer);
+            const u32 highAfter = Timer::GetCounter(LowTimer + 1);
+
+            if(high != highAfter)
+                return Timer::GetCounter(LowTimer) | (highAfter << 16);
+            return low | (high << 16);
+        }
+
+        u32 Stop()
+        {
+            Timer::GetControlRegister(LowTimer) = TimerControlRegister{};
+            Timer::GetControlRegister(LowTimer + 1) = TimerControlRegister{};
+            return Timer::GetCounter(LowTimer) | (static_cast<u32>(Timer::GetCounter(LowTimer + 1)) << 16);
+        }
+    };
+
+    template<class Func>
+    u32 MeasureCycles(Func&& func)
+    {
+        CycleCounter counter;
+        counter.Start();
+        std::forward<Func>(func)();
+        return counter.Stop();
+    }
+}
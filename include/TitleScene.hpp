@@ -0,0 +1,24 @@
+#pragma once
+#include "SceneManager.hpp"
+#include "Coroutine.hpp"
+
+//Snake spelled out in snake tiles with a blinking apple, A or Start starts the game while the board is streamed in behind it
+class TitleScene : public cgba::Scene
+{
+private:
+    cgba::Scene& game;
+    cgba::VramHandle tiles;
+    cgba::VramHandle map;
+    cgba::WordBool blinking = false;
+
+public:
+    TitleScene(cgba::SceneContext& _context, cgba::Scene& _game);
+
+    void Preload() override;
+    void Enter(cgba::DisplayState& display) override;
+    void Exit() override;
+    void Update(cgba::SceneManager& scenes) override;
+
+private:
+    cgba::Task BlinkApple();
+};
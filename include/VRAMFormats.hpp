@@ -1,9 +1,11 @@
 #pragma once
 #include <array>
+#include <algorithm>
 #include "Math.hpp"
 #include "Types.hpp"
 #include "MemoryRegion.hpp"
 #include "PackedRegister.hpp"
+#include "FastMemory.hpp"
 
 namespace cgba
 {
@@ -118,6 +120,17 @@ namespace cgba
             return baseAddress[index];
         }
 
+        template<std::size_t Count>
+        void Load(const std::array<RGB15, Count>& colors, u32 firstIndex = 0)
+        {
+            FastMemory::Copy16(reinterpret_cast<volatile u16*>(&baseAddress[firstIndex]), reinterpret_cast<const u16*>(colors.data()), Count);
+        }
+
+        void Fill(RGB15 color, u32 firstIndex, u32 count)
+        {
+            FastMemory::Fill16(reinterpret_cast<volatile u16*>(&baseAddress[firstIndex]), color.Data(), count);
+        }
+
     private:
         PaletteViewTemplate(uintptr paletteAddress, Range<u32, 0, 15> paletteNumber) requires (Mode == PaletteMode::Color16_Palette16) :
             baseAddress{ &Memory<VolatileRGB15>(paletteAddress + palette_block_increments * paletteNumber) }
@@ -148,13 +161,27 @@ namespace cgba
 
         constexpr CharacterTileTemplate() = default;
 
-        //TODO: Implement this
-        constexpr CharacterTileTemplate(const std::array<Palette256Index, Area(tileSizePixels)>& _data);
+        //Packs two pixels per byte with the left pixel in the low nibble, every index must fit in 16 colors
+        constexpr CharacterTileTemplate(const std::array<Palette256Index, Area(tileSizePixels)>& _data) :
+            data{}
+        {
+            for(u32 i = 0; i < data.size(); i++)
+            {
+                CGBA_ASSERT(_data[i * 2].index < 16 && _data[i * 2 + 1].index < 16, "Pixel index doesn't fit in a 16 color palette");
+                data[i].index = static_cast<u8>(_data[i * 2].index | (_data[i * 2 + 1].index << 4));
+            }
+        }
+
         constexpr CharacterTileTemplate(const std::array<Palette16Index, Area(tileSizePixels) / 2>& _data) :
             data{ _data }
         {
             
         }
+
+        constexpr u8 GetPixel(u32 index) const
+        {
+            return (data[index / 2].index >> ((index % 2) * 4)) & 0xF;
+        }
     };
 
     template<bool IsVolatile>
@@ -162,12 +189,80 @@ namespace cgba
     {
         using PaletteIndex = PaletteIndexTemplate<PaletteMode::Color256_Palette1, IsVolatile>;
         std::array<PaletteIndex, Area(tileSizePixels)> data;
+
+        constexpr CharacterTileTemplate() = default;
+
+        constexpr CharacterTileTemplate(const std::array<Palette256Index, Area(tileSizePixels)>& _data) :
+            data{ _data }
+        {
+
+        }
+
+        //Unpacks a 16 color tile, moving every non transparent pixel into the 16 color bank paletteNumber of the 256 color palette
+        constexpr explicit CharacterTileTemplate(const CharacterTileTemplate<PaletteMode::Color16_Palette16, false>& tile, Range<u32, 0, 15> paletteNumber = 0) :
+            data{}
+        {
+            for(u32 i = 0; i < data.size(); i++)
+            {
+                const u8 pixel = tile.GetPixel(i);
+                data[i].index = static_cast<u8>(pixel + (pixel != 0) * paletteNumber * 16);
+            }
+        }
+
+        constexpr u8 GetPixel(u32 index) const
+        {
+            return data[index].index;
+        }
     };
     
 
     using CharacterTile16 = CharacterTileTemplate<PaletteMode::Color16_Palette16, false>;
     using CharacterTile256 = CharacterTileTemplate<PaletteMode::Color256_Palette1, false>;
 
+    template<PaletteMode Mode>
+    using PaletteRemap = std::array<u8, Mode == PaletteMode::Color16_Palette16 ? 16 : 256>;
+
+    //Replaces every pixel index i of the tile with remap[i], e.g. to share a palette between tiles authored against different ones
+    template<PaletteMode Mode>
+    constexpr CharacterTileTemplate<Mode, false> RemapPalette(const CharacterTileTemplate<Mode, false>& tile, const PaletteRemap<Mode>& remap)
+    {
+        CharacterTileTemplate<Mode, false> remapped = tile;
+        for(auto& pixels : remapped.data)
+        {
+            if constexpr(Mode == PaletteMode::Color16_Palette16)
+            {
+                CGBA_ASSERT(remap[pixels.index & 0xF] < 16 && remap[pixels.index >> 4] < 16, "Remapped index doesn't fit in a 16 color palette");
+                pixels.index = static_cast<u8>(remap[pixels.index & 0xF] | (remap[pixels.index >> 4] << 4));
+            }
+            else
+            {
+                pixels.index = remap[pixels.index];
+            }
+        }
+        return remapped;
+    }
+
+    template<PaletteMode Mode, std::size_t Count>
+    constexpr std::array<CharacterTileTemplate<Mode, false>, Count> RemapPalette(const std::array<CharacterTileTemplate<Mode, false>, Count>& tiles, const PaletteRemap<Mode>& remap)
+    {
+        std::array<CharacterTileTemplate<Mode, false>, Count> remapped{};
+        for(std::size_t i = 0; i < Count; i++)
+            remapped[i] = RemapPalette<Mode>(tiles[i], remap);
+        return remapped;
+    }
+
+    static_assert([]
+    {
+        std::array<Palette256Index, Area(tileSizePixels)> pixels{};
+        for(u32 i = 0; i < pixels.size(); i++)
+            pixels[i].index = static_cast<u8>(i % 16);
+
+        const CharacterTile16 packed{ pixels };
+        const CharacterTile256 unpacked{ packed, 2 };
+        const CharacterTile16 remapped = RemapPalette(packed, PaletteRemap<PaletteMode::Color16_Palette16>{ 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+        return packed.data[0].index == 0x10 && unpacked.GetPixel(16) == 0 && unpacked.GetPixel(17) == 33 && remapped.GetPixel(1) == 14;
+    }());
+
     template<PaletteMode Mode>
     struct PaletteModeToType;
 
@@ -204,6 +299,35 @@ namespace cgba
         {
             return baseAddress[index];
         }
+
+        //VRAM duplicates 8 bit writes across the whole halfword, so tiles are copied 16 bits at a time or wider
+        template<std::size_t Count>
+        void Load(const std::array<CharacterTileTemplate<Mode, false>, Count>& tiles, u32 firstTile = 0)
+        {
+            FastMemory::Copy16(reinterpret_cast<volatile u16*>(&baseAddress[firstTile]), reinterpret_cast<const u16*>(tiles.data()), sizeof(tiles) / sizeof(u16));
+        }
+
+        //Unpacks 16 color tiles into the 16 color bank paletteNumber, the tiles must be word aligned like the ones from tools/tile_converter.py
+        template<std::size_t Count>
+        void Load(const std::array<CharacterTileTemplate<PaletteMode::Color16_Palette16, false>, Count>& tiles, Range<u32, 0, 15> paletteNumber, u32 firstTile = 0) requires (Mode == PaletteMode::Color256_Palette1)
+        {
+            CGBA_ASSERT(FastMemory::IsWordAligned(tiles.data()), "Tiles must be word aligned");
+            FastMemory::ConvertTiles16To256(&baseAddress[firstTile], tiles.data(), Count, paletteNumber);
+        }
+
+        //Sets every pixel of tileCount tiles to one palette index
+        void Fill(u32 firstTile, u32 tileCount, u8 index = 0)
+        {
+            CGBA_ASSERT(Mode == PaletteMode::Color256_Palette1 || index < 16, "Pixel index doesn't fit in a 16 color palette");
+            constexpr u32 pixelsPerWord = (Mode == PaletteMode::Color16_Palette16) ? 8 : 4;
+            constexpr u32 bitsPerPixel = 32 / pixelsPerWord;
+
+            u32 value = 0;
+            for(u32 i = 0; i < pixelsPerWord; i++)
+                value |= static_cast<u32>(index) << (i * bitsPerPixel);
+
+            FastMemory::Fill32(&baseAddress[firstTile], value, tileCount * sizeof(tile_type) / sizeof(u32));
+        }
     };
 
     using CharacterBlockView16 = CharacterBlockViewTemplate<PaletteMode::Color16_Palette16>;
@@ -215,16 +339,15 @@ namespace cgba
         using Flip_Horizontal = u16PackedRegisterData<WordBool, 1, 10>; 
         using Flip_Vertical = u16PackedRegisterData<WordBool, 1, 11>; 
         using Palette_Number = u16PackedRegisterData<Range<u32, 0, 15>, 4, 12>;
+        using All_Fields = PackedRegisterFields<Tile_Number, Flip_Horizontal, Flip_Vertical, Palette_Number>;
                 
         ConditionallyVolatile_T<u16, false> data;
 
         constexpr TextBackgroundTileDescription() = default;
-        constexpr TextBackgroundTileDescription(Tile_Number::type tileNumber, Flip_Horizontal::type flipHorizontal, Flip_Vertical::type flipVertical, Palette_Number::type Palette)
+        constexpr TextBackgroundTileDescription(Tile_Number::type tileNumber, Flip_Horizontal::type flipHorizontal, Flip_Vertical::type flipVertical, Palette_Number::type Palette) :
+            data{ All_Fields::Pack(tileNumber, flipHorizontal, flipVertical, Palette) }
         {
-            SetTileNumber(tileNumber);
-            Flip_Horizontal::Set(data, flipHorizontal);
-            Flip_Vertical::Set(data, flipVertical);
-            Palette_Number::Set(data, Palette);
+
         }
 
         constexpr void SetTileNumber(Tile_Number::type value)
@@ -314,6 +437,10 @@ namespace cgba
         W1024_H1024 = 3
     };
     
+    constexpr Rectangle screenBlockSizeTiles{ 32, 32 };
+
+    //Text maps larger than 32x32 tiles are stored by hardware as consecutive 32x32 screen blocks,
+    //left to right then top to bottom, so TileIndex maps a tile position to its offset from the base block
     template<auto Mode>
     struct ScreenSizeConstants;
 
@@ -323,6 +450,9 @@ namespace cgba
         static constexpr Rectangle screenSizePixels{ 256, 256 };
         static constexpr Rectangle screenSizeTiles{ 32, 32 };
         using TileDescription = TextBackgroundTileDescription;
+        static constexpr Rectangle screenSizeBlocks{ 1, 1 };
+
+        static constexpr u32 TileIndex(u32 x, u32 y) { return x + (y << 5); }
     };
 
     template<>
@@ -331,6 +461,9 @@ namespace cgba
         static constexpr Rectangle screenSizePixels{ 512, 256 };
         static constexpr Rectangle screenSizeTiles{ 64, 32 };
         using TileDescription = TextBackgroundTileDescription;
+        static constexpr Rectangle screenSizeBlocks{ 2, 1 };
+
+        static constexpr u32 TileIndex(u32 x, u32 y) { return (x & 31) + (y << 5) + ((x >> 5) << 10); }
     };
 
     template<>
@@ -339,6 +472,9 @@ namespace cgba
         static constexpr Rectangle screenSizePixels{ 256, 512 };
         static constexpr Rectangle screenSizeTiles{ 32, 64 };
         using TileDescription = TextBackgroundTileDescription;
+        static constexpr Rectangle screenSizeBlocks{ 1, 2 };
+
+        static constexpr u32 TileIndex(u32 x, u32 y) { return x + (y << 5); }
     };
 
     template<>
@@ -347,6 +483,9 @@ namespace cgba
         static constexpr Rectangle screenSizePixels{ 512, 512 };
         static constexpr Rectangle screenSizeTiles{ 64, 64 };
         using TileDescription = TextBackgroundTileDescription;
+        static constexpr Rectangle screenSizeBlocks{ 2, 2 };
+
+        static constexpr u32 TileIndex(u32 x, u32 y) { return (x & 31) + ((y & 31) << 5) + ((x >> 5) << 10) + ((y >> 5) << 11); }
     };
 
     template<>
@@ -399,6 +538,21 @@ namespace cgba
         {
             return baseAddress[index];
         }
+        
+        description_type& operator[](Point<i16> index)
+        {
+            return baseAddress[index.x + index.y * screenBlockSizeTiles.width];
+        }
+
+        void Load(const std::array<description_type, Area(screenBlockSizeTiles)>& map)
+        {
+            FastMemory::Copy16(reinterpret_cast<volatile u16*>(baseAddress), reinterpret_cast<const u16*>(map.data()), map.size());
+        }
+
+        void Fill(description_type description)
+        {
+            FastMemory::Fill16(reinterpret_cast<volatile u16*>(baseAddress), description.data, Area(screenBlockSizeTiles));
+        }
     };
 
     template<TextScreenSizeMode SizeMode>
@@ -406,9 +560,76 @@ namespace cgba
     {
     private:
         using description_type = TextBackgroundTileDescription;
+        using SizeConstants = ScreenSizeConstants<SizeMode>;
 
         description_type* baseAddress;
 
+    public:
+        //Walks a row of tiles in order, stepping into the next screen block when the row crosses a 32 tile boundary
+        class RowIterator
+        {
+        private:
+            description_type* address;
+            u32 x;
+
+        public:
+            constexpr RowIterator(description_type* _address, u32 _x) :
+                address{ _address },
+                x{ _x }
+            {
+
+            }
+
+            description_type& operator*() const { return *address; }
+
+            RowIterator& operator++()
+            {
+                x++;
+                address++;
+                if constexpr(SizeConstants::screenSizeTiles.width > screenBlockSizeTiles.width)
+                    address += static_cast<u32>((x % screenBlockSizeTiles.width) == 0) * (Area(screenBlockSizeTiles) - screenBlockSizeTiles.width);
+                return *this;
+            }
+
+            u32 GetX() const { return x; }
+
+            friend constexpr bool operator==(const RowIterator& lh, const RowIterator& rh) { return lh.x == rh.x; }
+        };
+
+        //Walks the 32x32 screen blocks backing the map in hardware order
+        class BlockIterator
+        {
+        private:
+            u32 block;
+
+        public:
+            constexpr BlockIterator(u32 _block) :
+                block{ _block }
+            {
+
+            }
+
+            TextScreenBlockView operator*() const { return TextScreenBlockView{ block }; }
+
+            BlockIterator& operator++()
+            {
+                block++;
+                return *this;
+            }
+
+            friend constexpr bool operator==(const BlockIterator& lh, const BlockIterator& rh) = default;
+        };
+
+        template<class Iterator>
+        struct IteratorRange
+        {
+            Iterator first;
+            Iterator last;
+
+            Iterator begin() const { return first; }
+            Iterator end() const { return last; }
+        };
+
     public:
         StaticTextScreenBlockView(Range<u32, 0, 31> baseBlock) :
             baseAddress{ &Memory<description_type>(vram + screen_block_increments * baseBlock)}
@@ -418,13 +639,72 @@ namespace cgba
         
         description_type& operator[](u32 index)
         {
-            BN_ASSERT(index < Area(ScreenSizeConstants<SizeMode>::screenSizeTiles));
+            CGBA_ASSERT(index < Area(SizeConstants::screenSizeTiles));
             return baseAddress[index];
         }
         
         description_type& operator[](Point<i16> index)
         {
-            return operator[](index.x + index.y * ScreenSizeConstants<SizeMode>::screenSizeTiles.width);
+            CGBA_ASSERT(static_cast<u32>(index.x) < static_cast<u32>(SizeConstants::screenSizeTiles.width)
+                && static_cast<u32>(index.y) < static_cast<u32>(SizeConstants::screenSizeTiles.height));
+            return baseAddress[SizeConstants::TileIndex(index.x, index.y)];
+        }
+
+        //Copies a map of mapSizeTiles tiles, stored row by row, with its top left corner placed at origin
+        template<std::size_t Count>
+        void Load(const std::array<description_type, Count>& map, Rectangle mapSizeTiles, Point<i16> origin = {})
+        {
+            CGBA_ASSERT(static_cast<std::size_t>(Area(mapSizeTiles)) == Count);
+            CGBA_ASSERT(origin.x + mapSizeTiles.width <= SizeConstants::screenSizeTiles.width
+                && origin.y + mapSizeTiles.height <= SizeConstants::screenSizeTiles.height);
+
+            //Rows are copied in runs that stay within one screen block
+            for(i32 y = 0; y < mapSizeTiles.height; y++)
+            {
+                for(i32 x = 0; x < mapSizeTiles.width;)
+                {
+                    const u32 screenX = origin.x + x;
+                    const u32 run = std::min<u32>(mapSizeTiles.width - x, screenBlockSizeTiles.width - screenX % screenBlockSizeTiles.width);
+                    FastMemory::Copy16(reinterpret_cast<volatile u16*>(&baseAddress[SizeConstants::TileIndex(screenX, origin.y + y)]),
+                        reinterpret_cast<const u16*>(&map[x + y * mapSizeTiles.width]), run);
+                    x += run;
+                }
+            }
+        }
+
+        void Fill(description_type description)
+        {
+            FastMemory::Fill16(reinterpret_cast<volatile u16*>(baseAddress), description.data, Area(SizeConstants::screenSizeTiles));
+        }
+
+        u32 GetBaseBlock() const
+        {
+            return (reinterpret_cast<uintptr>(baseAddress) - vram) / screen_block_increments;
+        }
+
+        IteratorRange<RowIterator> GetRow(Range<u32, 0, SizeConstants::screenSizeTiles.height - 1> y)
+        {
+            return { { &baseAddress[SizeConstants::TileIndex(0, y)], 0 }, { nullptr, static_cast<u32>(SizeConstants::screenSizeTiles.width) } };
+        }
+
+        IteratorRange<BlockIterator> GetBlocks()
+        {
+            return { { GetBaseBlock() }, { GetBaseBlock() + Area(SizeConstants::screenSizeBlocks) } };
+        }
+
+        //Tile position of the top left corner of the nth block returned by GetBlocks
+        static constexpr Point<i16> GetBlockOrigin(u32 block)
+        {
+            return { 
+                static_cast<i16>((block % SizeConstants::screenSizeBlocks.width) * screenBlockSizeTiles.width),
+                static_cast<i16>((block / SizeConstants::screenSizeBlocks.width) * screenBlockSizeTiles.height) };
         }
     };
+
+    static_assert(ScreenSizeConstants<TextScreenSizeMode::W512_H256>::TileIndex(31, 31) == 1023);
+    static_assert(ScreenSizeConstants<TextScreenSizeMode::W512_H256>::TileIndex(32, 0) == 1024);
+    static_assert(ScreenSizeConstants<TextScreenSizeMode::W256_H512>::TileIndex(0, 32) == 1024);
+    static_assert(ScreenSizeConstants<TextScreenSizeMode::W512_H512>::TileIndex(32, 31) == 1024 + 31 * 32);
+    static_assert(ScreenSizeConstants<TextScreenSizeMode::W512_H512>::TileIndex(0, 32) == 2048);
+    static_assert(ScreenSizeConstants<TextScreenSizeMode::W512_H512>::TileIndex(63, 63) == 4095);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+#include "Types.hpp"
+#include "Math.hpp"
+#include "VRAMFormats.hpp"
+#include <array>
+
+namespace cgba
+{
+    enum class VramRegion : u32
+    {
+        //0x0600'0000 to 0x0600'FFFF, shared by character blocks and screen blocks
+        Background = 0,
+
+        //0x0601'0000 to 0x0601'7FFF
+        Object = 1
+    };
+
+    struct VramHandle
+    {
+        static constexpr u32 invalidIndex = 0xFFFF'FFFF;
+
+        u32 index = invalidIndex;
+
+        constexpr WordBool IsValid() const { return index != invalidIndex; }
+        friend constexpr bool operator==(const VramHandle& lh, const VramHandle& rh) = default;
+    };
+
+    //Bytes in use, in units of 32 bytes (one 16 color tile), per 2KB screen block of each region
+    struct VramUsageMap
+    {
+        std::array<u8, 32> background;
+        std::array<u8, 16> object;
+        u32 allocationCount;
+    };
+
+    //Hands out screen blocks and tile ranges without letting them overlap.
+    //Character block n covers screen blocks 8n to 8n + 7, so both kinds of allocation share one map of the background region.
+    //Tile ranges are reference counted and can be shared by passing the same key, usually the address of the source asset
+    class VramAllocator
+    {
+    public:
+        static constexpr u32 maxAllocations = 64;
+        static constexpr u32 unitSize = 32;
+        static constexpr u32 backgroundUnits = 64 * 1024 / unitSize;
+        static constexpr u32 objectUnits = 32 * 1024 / unitSize;
+        static constexpr u32 screenBlockUnits = screen_block_increments / unitSize;
+        static constexpr u32 characterBlockUnits = character_block_increments / unitSize;
+
+    private:
+        struct Allocation
+        {
+            const void* key;
+            VramRegion region;
+            u32 firstUnit;
+            u32 unitCount;
+
+            //Range the allocation can be moved within, tile numbers stop being addressable past windowEnd
+            u32 windowStart;
+            u32 windowEnd;
+            u32 alignment;
+            u32 referenceCount;
+            WordBool relocatable;
+        };
+
+        std::array<Allocation, maxAllocations> allocations;
+        std::array<u32, backgroundUnits / 32> backgroundUsage;
+        std::array<u32, objectUnits / 32> objectUsage;
+        WordBool defragmentOnLoad;
+
+    public:
+        //When defragmentOnLoad is set a failed allocation compacts the relocatable tile ranges and tries again,
+        //so only enable it while loading, when moving tiles under a displayed layer can't be seen
+        explicit VramAllocator(WordBool _defragmentOnLoad = false);
+
+        //Screen blocks are taken from the end of VRAM so low character blocks stay free for tiles
+        VramHandle AllocateScreenBlocks(Range<u32, 1, 4> count);
+        VramHandle AllocateScreenBlocks(TextScreenSizeMode mode);
+
+        //Tile numbers are relative to characterBaseBlock so the range stays within the 1024 tiles a text background can address
+        VramHandle AllocateBackgroundTiles(Range<u32, 0, 3> characterBaseBlock, u32 tileCount, PaletteMode mode, const void* key = nullptr, WordBool relocatable = false);
+
+        //Bitmap modes use the lower half of object VRAM as frame buffer, leaving tiles 512 to 1023
+        VramHandle AllocateObjectTiles(u32 tileCount, PaletteMode mode, const void* key = nullptr, WordBool relocatable = false, WordBool bitmapMode = false);
+
+        void Retain(VramHandle handle);
+        void Release(VramHandle handle);
+
+        //Returns an invalid handle when nothing was allocated with the key
+        VramHandle Find(const void* key) const;
+
+        u32 GetScreenBaseBlock(VramHandle handle) const;
+
+        //Background tiles are numbered from their character base block, object tiles from the start of object VRAM in 32 byte steps
+        u32 GetFirstTile(VramHandle handle) const;
+        volatile void* GetAddress(VramHandle handle) const;
+
+        //Moves relocatable tile ranges towards the start of their window, the handles stay valid but GetFirstTile may change
+        void Defragment();
+        void Reset();
+
+        VramUsageMap GetUsageMap() const;
+
+    private:
+        VramHandle Allocate(const Allocation& allocation, WordBool fromEnd);
+        u32 FindFree(VramRegion region, u32 unitCount, u32 windowStart, u32 windowEnd, u32 alignment, WordBool fromEnd) const;
+        WordBool IsFree(VramRegion region, u32 firstUnit, u32 unitCount) const;
+        void Mark(VramRegion region, u32 firstUnit, u32 unitCount, WordBool used);
+        u32* GetUsage(VramRegion region) { return region == VramRegion::Background ? backgroundUsage.data() : objectUsage.data(); }
+        const u32* GetUsage(VramRegion region) const { return region == VramRegion::Background ? backgroundUsage.data() : objectUsage.data(); }
+        static uintptr GetRegionAddress(VramRegion region) { return region == VramRegion::Background ? vram : object_vram; }
+    };
+}
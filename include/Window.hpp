@@ -0,0 +1,192 @@
+#pragma once
+#include "Types.hpp"
+#include "MemoryRegion.hpp"
+#include "Math.hpp"
+#include "PackedRegister.hpp"
+#include "Display.hpp"
+#include <array>
+
+namespace cgba
+{
+    enum class WindowLayer : u32
+    {
+        Background0 = 0,
+        Background1 = 1,
+        Background2 = 2,
+        Background3 = 3,
+        Objects = 4,
+
+        //Lets BLDCNT effects apply to pixels in the region
+        Blend = 5
+    };
+
+    enum class WindowRegion : u32
+    {
+        //Held in WININ
+        Window0 = 0,
+        Window1 = 1,
+
+        //Held in WINOUT
+        Outside = 2,
+        Object_Window = 3
+    };
+
+    //WIN0H/WIN1H and WIN0V/WIN1V can't be read back, so they're built whole.
+    //The end coordinate is exclusive, an end before the start makes the window run to the edge of the screen
+    struct WindowBoundsRegister
+    {
+        using End = u16PackedRegisterData<Range<u32, 0, 255>, 8, 0>;
+        using Start = u16PackedRegisterData<Range<u32, 0, 255>, 8, 8>;
+
+        u16 data = 0;
+
+        WindowBoundsRegister() = default;
+        WindowBoundsRegister(Start::type start, End::type end) :
+            data{ PackedRegisterFields<Start, End>::Pack(start, end) }
+        {
+
+        }
+    };
+
+    //WININ holds the layers of window 0 and 1, WINOUT the ones of the outside and the object window, 6 bits each in the same layout
+    template<bool Volatile>
+    struct WindowLayersRegisterTemplate
+    {
+        using Low_Region_Layers = u16PackedRegisterData<u32, 6, 0>;
+        using High_Region_Layers = u16PackedRegisterData<u32, 6, 8>;
+
+        static constexpr u32 allLayers = (1 << 6) - 1;
+
+        ConditionallyVolatile_T<u16, Volatile> data;
+
+        WindowLayersRegisterTemplate() = default;
+        WindowLayersRegisterTemplate(const WindowLayersRegisterTemplate<!Volatile>& other) :
+            data{ other.data }
+        {
+
+        }
+
+        WindowLayersRegisterTemplate& operator=(const WindowLayersRegisterTemplate& other) = default;
+        WindowLayersRegisterTemplate& operator=(const WindowLayersRegisterTemplate<!Volatile>& other)
+        {
+            data = other.data;
+            return *this;
+        }
+
+        //Region 0 is window 0 or the outside, region 1 is window 1 or the object window
+        void EnableLayer(Range<u32, 0, 1> region, WindowLayer layer)
+        {
+            data |= 1 << (static_cast<u32>(layer) + region * High_Region_Layers::bitShift);
+        }
+
+        void DisableLayer(Range<u32, 0, 1> region, WindowLayer layer)
+        {
+            data &= ~(1 << (static_cast<u32>(layer) + region * High_Region_Layers::bitShift));
+        }
+
+        WordBool IsLayerEnabled(Range<u32, 0, 1> region, WindowLayer layer) const
+        {
+            return (data >> (static_cast<u32>(layer) + region * High_Region_Layers::bitShift)) & 1;
+        }
+
+        //Bit n of layers is WindowLayer n
+        void SetLayers(Range<u32, 0, 1> region, u32 layers)
+        {
+            if(region == 0)
+                Low_Region_Layers::Set(data, layers);
+            else
+                High_Region_Layers::Set(data, layers);
+        }
+
+        u32 GetLayers(Range<u32, 0, 1> region) const
+        {
+            return region == 0 ? Low_Region_Layers::Get(data) : High_Region_Layers::Get(data);
+        }
+    };
+
+    using WindowLayersRegister = WindowLayersRegisterTemplate<false>;
+    using VolatileWindowLayersRegister = WindowLayersRegisterTemplate<true>;
+
+    static_assert(sizeof(WindowBoundsRegister) == 2);
+    static_assert(sizeof(WindowLayersRegister) == 2);
+
+    struct Window
+    {
+        static volatile u16& GetHorizontalRegister(Range<u32, 0, 1> window)
+        {
+            return Memory<volatile u16>(window_horizontal_register_base_address, window);
+        }
+
+        static volatile u16& GetVerticalRegister(Range<u32, 0, 1> window)
+        {
+            return Memory<volatile u16>(window_vertical_register_base_address, window);
+        }
+
+        static VolatileWindowLayersRegister& GetInsideRegister()
+        {
+            return Memory<VolatileWindowLayersRegister>(window_inside_register);
+        }
+
+        static VolatileWindowLayersRegister& GetOutsideRegister()
+        {
+            return Memory<VolatileWindowLayersRegister>(window_outside_register);
+        }
+
+        //Covers left to right - 1 and top to bottom - 1, the window still has to be shown through the display control register
+        static void SetBounds(Range<u32, 0, 1> window, u32 left, u32 top, u32 right, u32 bottom)
+        {
+            GetHorizontalRegister(window) = WindowBoundsRegister{ left, right }.data;
+            GetVerticalRegister(window) = WindowBoundsRegister{ top, bottom }.data;
+        }
+
+        static void SetLayers(WindowRegion region, u32 layers)
+        {
+            const u32 index = static_cast<u32>(region);
+            VolatileWindowLayersRegister& layersRegister = (index < 2) ? GetInsideRegister() : GetOutsideRegister();
+
+            WindowLayersRegister value = layersRegister;
+            value.SetLayers(index % 2, layers);
+            layersRegister = value;
+        }
+
+        static u32 GetLayers(WindowRegion region)
+        {
+            const u32 index = static_cast<u32>(region);
+            const WindowLayersRegister value = (index < 2) ? GetInsideRegister() : GetOutsideRegister();
+            return value.GetLayers(index % 2);
+        }
+    };
+
+    //Changes the horizontal span of a window every scanline with HBlank DMA, giving it any shape made of one span per line.
+    //Line 0 is written at VBlank and the DMA copies the rest of the table after each drawn line
+    class ShapedWindow
+    {
+    public:
+        static constexpr u32 lineCount = Display::hardwareScreenSizePixels.height;
+
+    private:
+        //One extra entry for the HBlank after the last line, which is copied before VBlank starts
+        std::array<u16, lineCount + 1> spans{};
+        u32 window;
+        u32 dmaChannel;
+
+    public:
+        //DMA 3 is left alone since it does the general copies
+        explicit ShapedWindow(Range<u32, 0, 1> _window, Range<u32, 0, 2> _dmaChannel = 0);
+
+        //Lines the window doesn't cover get an empty span
+        void SetSpan(Range<u32, 0, lineCount - 1> line, i32 left, i32 right);
+        void Clear();
+
+        //Spotlight with its center at center, lines outside the screen are clipped
+        void SetCircle(Point<i16> center, u32 radius);
+
+        //Covers everything left of a 45 degree edge crossing the top of the screen at edge, moving edge from 0 to 400 wipes over the whole screen
+        void SetDiagonalWipe(i32 edge);
+
+        //Call at the start of VBlank, the table is read by DMA while drawing so it shouldn't change until the next VBlank
+        void CommitVBlank();
+
+        void Stop();
+    };
+}
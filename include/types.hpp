@@ -1,10 +1,11 @@
 #pragma once
-#include "bn_cstring.h"
 #include <concepts>
+#include <cstdint>
 
 namespace cgba
 {
-    using uintptr = unsigned int;
+    //unsigned int on the GBA, also wide enough for pointers when code is built on the host
+    using uintptr = std::uintptr_t;
 
     static_assert(sizeof(uintptr) == sizeof(void*));
 
@@ -0,0 +1,58 @@
+#include "Arena.hpp"
+#include "Sections.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        CGBA_BSS_IWRAM alignas(8) u8 iwramArenaBuffer[MemoryArenas::iwramArenaSize];
+        CGBA_BSS_EWRAM alignas(8) u8 ewramArenaBuffer[MemoryArenas::ewramArenaSize];
+
+        Arena iwramArena{ iwramArenaBuffer, MemoryArenas::iwramArenaSize };
+        Arena ewramArena{ ewramArenaBuffer, MemoryArenas::ewramArenaSize };
+    }
+
+    Arena::Arena(void* _buffer, u32 _size) :
+        buffer{ static_cast<u8*>(_buffer) },
+        size{ _size }
+    {
+
+    }
+
+    void* Arena::Allocate(u32 bytes, u32 alignment)
+    {
+        CGBA_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+
+        const uintptr address = reinterpret_cast<uintptr>(buffer) + top;
+        const u32 padding = static_cast<u32>((alignment - (address & (alignment - 1))) & (alignment - 1));
+        if(bytes > size - top || padding > size - top - bytes)
+            return nullptr;
+
+        top += padding;
+        void* memory = buffer + top;
+        top += bytes;
+        return memory;
+    }
+
+    void Arena::Reset(Marker marker)
+    {
+        CGBA_ASSERT(marker <= top, "Marker is past the top of the arena");
+        top = marker;
+    }
+
+    WordBool Arena::Contains(const void* pointer) const
+    {
+        const u8* bytePointer = static_cast<const u8*>(pointer);
+        return bytePointer >= buffer && bytePointer < buffer + size;
+    }
+
+    Arena& MemoryArenas::Iwram()
+    {
+        return iwramArena;
+    }
+
+    Arena& MemoryArenas::Ewram()
+    {
+        return ewramArena;
+    }
+}
@@ -0,0 +1,82 @@
+#include "Assert.hpp"
+#include "MemoryRegion.hpp"
+#include "Text.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        //mGBA debug console, REG_DEBUG_ENABLE reads back 0x1DEA after 0xC0DE is written to it when running in mGBA
+        constexpr uintptr debug_string_address = 0x04FF'F600;
+        constexpr uintptr debug_flags_register = 0x04FF'F700;
+        constexpr uintptr debug_enable_register = 0x04FF'F780;
+        constexpr u32 debugStringSize = 0x100;
+        constexpr u16 debugLevelFatal = 0;
+        constexpr u16 debugSend = 0x100;
+
+        class DebugLine
+        {
+            volatile char* text = &Memory<volatile char>(debug_string_address);
+            u32 length = 0;
+
+        public:
+            void Append(const char* value)
+            {
+                //The last byte is kept for the terminator
+                for(; *value != '\0' && length < debugStringSize - 1; value++)
+                    text[length++] = *value;
+            }
+
+            void AppendNumber(u32 value)
+            {
+                std::array<char, 11> digits{};
+                FormatDecimal(value, digits.data(), digits.size() - 1);
+                Append(digits.data());
+            }
+
+            void Send(u16 level)
+            {
+                text[length] = '\0';
+                Memory<volatile u16>(debug_flags_register) = level | debugSend;
+            }
+        };
+
+        void DefaultAssertHandler(const char* condition, const char* message, const char* file, int line)
+        {
+            Memory<volatile u16>(debug_enable_register) = 0xC0DE;
+            if(Memory<volatile u16>(debug_enable_register) == 0x1DEA)
+            {
+                DebugLine log;
+                log.Append(file);
+                log.Append(":");
+                log.AppendNumber(static_cast<u32>(line));
+                log.Append(": ");
+                log.Append(condition);
+                if(*message != '\0')
+                {
+                    log.Append(" - ");
+                    log.Append(message);
+                }
+                log.Send(debugLevelFatal);
+            }
+        }
+
+        AssertHandler assertHandler = DefaultAssertHandler;
+    }
+
+    AssertHandler SetAssertHandler(AssertHandler handler)
+    {
+        const AssertHandler previous = assertHandler;
+        assertHandler = handler ? handler : DefaultAssertHandler;
+        return previous;
+    }
+
+    void AssertFailed(const char* condition, const char* message, const char* file, int line)
+    {
+        assertHandler(condition, message, file, line);
+
+        //A handler returning would continue with broken state, so stay here
+        while(true)
+            asm volatile("" ::: "memory");
+    }
+}
@@ -0,0 +1,111 @@
+#include "AssetLoader.hpp"
+#include "Dma.hpp"
+#include <algorithm>
+
+namespace cgba
+{
+    namespace
+    {
+        //Small enough that the cycle budget is only overshot by a fraction of a scanline
+        constexpr u32 decodeChunkBytes = 256;
+
+        //Keeps each DMA count well inside the 16 bit count register
+        constexpr u32 maxDmaBytes = 32 * 1024;
+    }
+
+    AssetLoader::AssetLoader(u16* _stagingBuffer, u32 _stagingSize, u32 _cycleBudget, u32 _vblankByteBudget) :
+        jobs{},
+        stagingBuffer{ _stagingBuffer },
+        stagingSize{ _stagingSize },
+        cycleBudget{ _cycleBudget },
+        vblankByteBudget{ _vblankByteBudget }
+    {
+
+    }
+
+    WordBool AssetLoader::QueueCopy(const void* source, volatile void* destination, u32 size)
+    {
+        return Queue({ JobType::Copy, source, destination, size, 0 });
+    }
+
+    WordBool AssetLoader::QueueDecompress(const void* source, volatile void* destination)
+    {
+        const u32 size = CompressionHeader{ *static_cast<const u32*>(source) }.GetDecompressedSize();
+        CGBA_ASSERT(size <= stagingSize, "Decompressed asset doesn't fit in the staging buffer");
+        return Queue({ JobType::Decompress, source, destination, size, 0 });
+    }
+
+    void AssetLoader::Update()
+    {
+        //The staging buffer holds one asset at a time, which belongs to the first decompression in the queue
+        Job* job = nullptr;
+        for(u32 i = 0; i < jobCount && !job; i++)
+        {
+            if(JobAt(i).type == JobType::Decompress)
+                job = &JobAt(i);
+        }
+
+        if(!job)
+            return;
+
+        if(!decompressor)
+            decompressor.emplace(job->source, stagingBuffer);
+
+        counter.Start();
+        while(!decompressor->IsDone() && counter.GetElapsed() < cycleBudget)
+            decompressor->Decode(decodeChunkBytes);
+        counter.Stop();
+    }
+
+    void AssetLoader::CommitVBlank()
+    {
+        u32 budget = vblankByteBudget;
+
+        while(jobCount > 0)
+        {
+            Job& job = JobAt(0);
+            if(!IsReady(job))
+                break;
+
+            const u32 bytes = std::min({ job.size - job.copied, budget & ~3u, maxDmaBytes });
+            if(bytes == 0)
+                break;
+
+            const u8* source = (job.type == JobType::Copy) ? static_cast<const u8*>(job.source) : reinterpret_cast<const u8*>(stagingBuffer);
+            Dma::Copy(source + job.copied, static_cast<volatile u8*>(job.destination) + job.copied, bytes);
+            job.copied += bytes;
+            budget -= bytes;
+
+            if(job.copied == job.size)
+            {
+                if(job.type == JobType::Decompress)
+                    decompressor.reset();
+
+                firstJob = (firstJob + 1) % maxJobs;
+                jobCount--;
+            }
+        }
+    }
+
+    WordBool AssetLoader::Queue(const Job& job)
+    {
+        //VRAM and palette RAM can't be written a byte at a time
+        CGBA_ASSERT(job.size % 2 == 0, "Asset size must be a multiple of 2 bytes");
+
+        //An empty job would never copy a byte, so CommitVBlank could never complete it and the queue would stall behind it
+        if(job.size == 0)
+            return true;
+
+        if(jobCount == maxJobs)
+            return false;
+
+        jobs[(firstJob + jobCount) % maxJobs] = job;
+        jobCount++;
+        return true;
+    }
+
+    WordBool AssetLoader::IsReady(const Job& job) const
+    {
+        return job.type == JobType::Copy || (decompressor && decompressor->IsDone());
+    }
+}
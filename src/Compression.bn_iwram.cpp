@@ -0,0 +1,125 @@
+#include "Compression.hpp"
+
+namespace cgba
+{
+    WordBool Decompressor::Decode(u32 maxBytes)
+    {
+        const u32 size = header.GetDecompressedSize();
+        const u32 target = (size - written < maxBytes) ? size : written + maxBytes;
+
+        switch(header.GetType())
+        {
+        case CompressionType::LZ77:
+            DecodeLZ77(target);
+            break;
+        case CompressionType::Run_Length:
+            DecodeRunLength(target);
+            break;
+        case CompressionType::Huffman:
+            DecodeHuffman(target);
+            break;
+        }
+
+        if(IsDone())
+            Flush();
+
+        return IsDone();
+    }
+
+    void Decompressor::DecodeLZ77(u32 target)
+    {
+        while(written < target)
+        {
+            if(repeatRemaining > 0)
+            {
+                Write(Read(written - repeatDistance));
+                repeatRemaining--;
+                continue;
+            }
+
+            if(blockFlagsRemaining == 0)
+            {
+                blockFlags = *source++;
+                blockFlagsRemaining = 8;
+            }
+
+            blockFlagsRemaining--;
+            if(blockFlags & (1 << blockFlagsRemaining))
+            {
+                repeatRemaining = (source[0] >> 4) + 3;
+                repeatDistance = (((source[0] & 0xF) << 8) | source[1]) + 1;
+                source += 2;
+            }
+            else
+            {
+                Write(*source++);
+            }
+        }
+    }
+
+    void Decompressor::DecodeRunLength(u32 target)
+    {
+        while(written < target)
+        {
+            if(repeatRemaining == 0)
+            {
+                const u32 flag = *source++;
+                repeatIsRun = flag & 0x80;
+                if(repeatIsRun)
+                {
+                    repeatRemaining = (flag & 0x7F) + 3;
+                    repeatValue = *source++;
+                }
+                else
+                {
+                    repeatRemaining = (flag & 0x7F) + 1;
+                }
+            }
+
+            Write(repeatIsRun ? repeatValue : *source++);
+            repeatRemaining--;
+        }
+    }
+
+    void Decompressor::DecodeHuffman(u32 target)
+    {
+        const u32 unitSize = header.GetHuffmanUnitSize();
+
+        while(written < target)
+        {
+            const u8* node = treeRoot;
+            u32 value;
+
+            while(true)
+            {
+                if(bitsRemaining == 0)
+                {
+                    bits = *bitstream++;
+                    bitsRemaining = 32;
+                }
+
+                bitsRemaining--;
+                const u32 bit = (bits >> bitsRemaining) & 1;
+                const u32 entry = *node;
+
+                //Children are stored as a pair after the node's own pair, offset by the lower 6 bits
+                const u8* child = reinterpret_cast<const u8*>((reinterpret_cast<uintptr>(node) & ~static_cast<uintptr>(1)) + (entry & 0x3F) * 2 + 2) + bit;
+                if(entry & (0x80 >> bit))
+                {
+                    value = *child;
+                    break;
+                }
+                node = child;
+            }
+
+            unitAccumulator |= value << unitAccumulatorSize;
+            unitAccumulatorSize += unitSize;
+            if(unitAccumulatorSize == 8)
+            {
+                Write(unitAccumulator);
+                unitAccumulator = 0;
+                unitAccumulatorSize = 0;
+            }
+        }
+    }
+}
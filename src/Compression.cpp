@@ -0,0 +1,81 @@
+#include "Compression.hpp"
+#include "Timer.hpp"
+
+//Thumb code encodes the BIOS function number in the lower byte of swi, ARM code in bits 16 to 23
+#if defined(__thumb__)
+    #define CGBA_BIOS_CALL(function) "swi " #function
+#else
+    #define CGBA_BIOS_CALL(function) "swi " #function " << 16"
+#endif
+
+namespace cgba
+{
+    namespace
+    {
+        void BiosHuffUnComp(const void* source, volatile u16* destination)
+        {
+            register const void* r0 asm("r0") = source;
+            register volatile u16* r1 asm("r1") = destination;
+            asm volatile(CGBA_BIOS_CALL(0x13) : "+r"(r0), "+r"(r1) : : "r2", "r3", "r12", "memory");
+        }
+
+        void BiosLZ77UnCompVram(const void* source, volatile u16* destination)
+        {
+            register const void* r0 asm("r0") = source;
+            register volatile u16* r1 asm("r1") = destination;
+            asm volatile(CGBA_BIOS_CALL(0x12) : "+r"(r0), "+r"(r1) : : "r2", "r3", "r12", "memory");
+        }
+
+        void BiosRLUnCompVram(const void* source, volatile u16* destination)
+        {
+            register const void* r0 asm("r0") = source;
+            register volatile u16* r1 asm("r1") = destination;
+            asm volatile(CGBA_BIOS_CALL(0x15) : "+r"(r0), "+r"(r1) : : "r2", "r3", "r12", "memory");
+        }
+    }
+
+    Decompressor::Decompressor(const void* _source, volatile u16* _destination) :
+        source{ static_cast<const u8*>(_source) + sizeof(CompressionHeader) },
+        destination{ _destination },
+        header{ *static_cast<const u32*>(_source) }
+    {
+        CGBA_ASSERT((reinterpret_cast<uintptr>(_source) & 3) == 0, "Compressed data must be 4 byte aligned");
+
+        //The tree size byte counts the tree in halfwords minus one, the 32 bit aligned bitstream follows the tree
+        if(header.GetType() == CompressionType::Huffman)
+        {
+            treeRoot = source + 1;
+            bitstream = reinterpret_cast<const u32*>(source + (source[0] + 1) * 2);
+        }
+    }
+
+    void Decompress(const void* source, volatile u16* destination, DecompressionMethod method)
+    {
+        if(method == DecompressionMethod::Software)
+        {
+            Decompressor{ source, destination }.Decode();
+            return;
+        }
+
+        switch(CompressionHeader{ *static_cast<const u32*>(source) }.GetType())
+        {
+        case CompressionType::LZ77:
+            BiosLZ77UnCompVram(source, destination);
+            break;
+        case CompressionType::Run_Length:
+            BiosRLUnCompVram(source, destination);
+            break;
+        case CompressionType::Huffman:
+            BiosHuffUnComp(source, destination);
+            break;
+        }
+    }
+
+    DecompressionTiming CompareDecompression(const void* source, volatile u16* destination)
+    {
+        return {
+            MeasureCycles([&]{ Decompress(source, destination, DecompressionMethod::Software); }),
+            MeasureCycles([&]{ Decompress(source, destination, DecompressionMethod::Bios); })
+        };
+    }
+}
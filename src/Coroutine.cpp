@@ -0,0 +1,115 @@
+#include "Coroutine.hpp"
+#include "Arena.hpp"
+#include "Dma.hpp"
+#include "Sections.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        struct CoroutineFrame
+        {
+            alignas(8) u8 bytes[Task::maxFrameSize];
+        };
+
+        CGBA_BSS_EWRAM alignas(Pool<CoroutineFrame>::slotAlignment) u8 frameStorage[Pool<CoroutineFrame>::slotSize * Task::maxFrames];
+        Pool<CoroutineFrame> framePool{ frameStorage, Task::maxFrames };
+    }
+
+    void* Task::promise_type::operator new(std::size_t size) noexcept
+    {
+        CGBA_ASSERT(size <= maxFrameSize, "Coroutine frame doesn't fit in a pool slot");
+
+        //Asserts may be compiled out, an invalid task is returned instead of overrunning the slot
+        if(size > maxFrameSize)
+            return nullptr;
+
+        return framePool.New();
+    }
+
+    void Task::promise_type::operator delete(void* frame) noexcept
+    {
+        framePool.Delete(static_cast<CoroutineFrame*>(frame));
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        Clear();
+    }
+
+    WordBool TaskScheduler::Spawn(Task task, i32 priority)
+    {
+        if(!task.IsValid() || GetTaskCount() == maxTasks)
+            return false;
+
+        //Inserting now would move entries RunVBlank hasn't reached yet
+        if(running)
+            spawned[spawnedCount++] = { task.Release(), priority };
+        else
+            Insert({ task.Release(), priority });
+        return true;
+    }
+
+    void TaskScheduler::Insert(const Entry& entry)
+    {
+        //Kept sorted so RunVBlank is a single pass, new tasks go after the ones of the same priority
+        u32 index = taskCount;
+        while(index > 0 && tasks[index - 1].priority < entry.priority)
+        {
+            tasks[index] = tasks[index - 1];
+            index--;
+        }
+
+        tasks[index] = entry;
+        taskCount++;
+    }
+
+    void TaskScheduler::RunVBlank()
+    {
+        running = true;
+        u32 kept = 0;
+        for(u32 i = 0; i < taskCount; i++)
+        {
+            Entry entry = tasks[i];
+            Task::promise_type& promise = entry.handle.promise();
+
+            WordBool ready;
+            if(promise.waitingForDma)
+                ready = !Dma::IsBusy(promise.dmaChannel);
+            else
+                ready = promise.framesRemaining <= 1;
+
+            if(ready)
+            {
+                promise.waitingForDma = false;
+                promise.framesRemaining = 0;
+                entry.handle.resume();
+            }
+            else if(!promise.waitingForDma)
+            {
+                promise.framesRemaining--;
+            }
+
+            if(entry.handle.done())
+                entry.handle.destroy();
+            else
+                tasks[kept++] = entry;
+        }
+        taskCount = kept;
+        running = false;
+
+        for(u32 i = 0; i < spawnedCount; i++)
+            Insert(spawned[i]);
+        spawnedCount = 0;
+    }
+
+    void TaskScheduler::Clear()
+    {
+        for(u32 i = 0; i < taskCount; i++)
+            tasks[i].handle.destroy();
+        for(u32 i = 0; i < spawnedCount; i++)
+            spawned[i].handle.destroy();
+        taskCount = 0;
+        spawnedCount = 0;
+    }
+}
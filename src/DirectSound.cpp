@@ -0,0 +1,117 @@
+#include "DirectSound.hpp"
+#include "Dma.hpp"
+#include "Timer.hpp"
+#include <algorithm>
+
+namespace cgba
+{
+    DirectSound::DirectSound(DirectSoundRate rate, SoundFifo _fifo, Range<u32, 0, 1> _timer) :
+        mixer{ GetSampleRate(rate) },
+        fifo{ _fifo },
+        timer{ _timer },
+        samplesPerFrame{ GetSamplesPerFrame(rate) },
+        cyclesPerSample{ GetCyclesPerSample(rate) }
+    {
+
+    }
+
+    DirectSound::~DirectSound()
+    {
+        Stop();
+    }
+
+    void DirectSound::Start()
+    {
+        Stop();
+        buffers.fill(0);
+        running = true;
+        pendingStart = true;
+    }
+
+    void DirectSound::StartHardware()
+    {
+        static_assert(GetCyclesPerSample(DirectSoundRate::Hz10512) * startDelay < 0x1'0000, "The delayed first pop has to fit the timer");
+
+        Sound::Enable();
+        DirectSoundControl::Modify([&](DirectSoundControlRegister& control)
+        {
+            control.SetFifoVolume(fifo, DirectSoundVolume::Full);
+            control.SetFifoOutput(fifo, true, true, timer);
+            control.ResetFifo(fifo);
+        });
+
+        playingBuffer = 0;
+        StartDma(GetBuffer(0));
+
+        //Counts up from the reload value and pops a sample on every overflow. The FIFO DMA moves 16 samples whenever a pop leaves
+        //16 or fewer, and the frame is a multiple of 16 samples, so it's always at the same point of that cycle in VBlank.
+        //Delaying the first pop puts VBlank 8 samples before a transfer, so CommitVBlank can run up to 7 samples earlier or 8 later
+        //than this one and still find the DMA exactly wrapReadAhead samples past the second buffer.
+        //The reload value written while the timer runs is only used from the first overflow on
+        Timer::GetCounter(timer) = static_cast<u16>(0x1'0000 - startDelay * cyclesPerSample);
+        TimerControlRegister control{};
+        control.SetPrescaler(TimerPrescaler::Cycles1);
+        control.Start();
+        Timer::GetControlRegister(timer) = control;
+        Timer::GetCounter(timer) = static_cast<u16>(0x1'0000 - cyclesPerSample);
+    }
+
+    void DirectSound::Stop()
+    {
+        const WordBool hardwareRunning = running && !pendingStart;
+        running = false;
+        pendingStart = false;
+        if(!hardwareRunning)
+            return;
+
+        Timer::GetControlRegister(timer) = TimerControlRegister{};
+        Dma::Stop(Sound::GetFifoDmaChannel(fifo));
+        DirectSoundControl::Modify([&](DirectSoundControlRegister& control)
+        {
+            control.DisableFifo(fifo);
+            control.ResetFifo(fifo);
+        });
+    }
+
+    void DirectSound::CommitVBlank()
+    {
+        if(!running)
+            return;
+
+        //Starting in VBlank keeps every later CommitVBlank at about the same point of the timer's cycle
+        if(pendingStart)
+        {
+            pendingStart = false;
+            StartHardware();
+            return;
+        }
+
+        //The DMA carries on into the second buffer by itself, the samples it read past the second one came from the guard copy
+        playingBuffer ^= 1;
+        if(playingBuffer == 0)
+            StartDma(GetBuffer(0) + wrapReadAhead);
+    }
+
+    void DirectSound::Mix()
+    {
+        if(!running)
+            return;
+
+        const u32 mixBuffer = playingBuffer ^ 1;
+        mixer.Mix(GetBuffer(mixBuffer), samplesPerFrame);
+        if(mixBuffer == 0)
+            std::copy_n(GetBuffer(0), guardSize, GetBuffer(2));
+    }
+
+    void DirectSound::StartDma(const i8* source)
+    {
+        //The FIFO timing ignores the count and moves 4 words whenever the FIFO is half empty
+        DmaControlRegister control{};
+        control.SetDestinationAddressControl(DmaAddressControl::Fixed);
+        control.SetSourceAddressControl(DmaAddressControl::Increment);
+        control.SetTransferType(DmaTransferType::Bits32);
+        control.SetStartTiming(DmaStartTiming::Special);
+        control.EnableRepeat();
+        Dma::Start(Sound::GetFifoDmaChannel(fifo), source, &Memory<volatile u32>(Sound::GetFifoAddress(fifo)), 4, control);
+    }
+}
@@ -0,0 +1,115 @@
+@ Word copy, fill and tile conversion kernels, assembled as ARM and placed in IWRAM
+@ so they run from the 32 bit zero wait state bus instead of 16 bit ROM.
+@ The bulk of each transfer moves 8 words per LDM/STM pair.
+
+    .section .iwram, "ax", %progbits
+    .arm
+    .align 2
+
+@ void cgba_memcpy32(void* destination, const void* source, u32 wordCount)
+    .global cgba_memcpy32
+    .type cgba_memcpy32, %function
+cgba_memcpy32:
+    push    {r4-r10}
+    movs    r12, r2, lsr #3
+    beq     .Lcopy_words
+.Lcopy_blocks:
+    ldmia   r1!, {r3-r10}
+    stmia   r0!, {r3-r10}
+    subs    r12, r12, #1
+    bne     .Lcopy_blocks
+.Lcopy_words:
+    ands    r2, r2, #7
+    beq     .Lcopy_done
+.Lcopy_word:
+    ldr     r3, [r1], #4
+    str     r3, [r0], #4
+    subs    r2, r2, #1
+    bne     .Lcopy_word
+.Lcopy_done:
+    pop     {r4-r10}
+    bx      lr
+    .size cgba_memcpy32, . - cgba_memcpy32
+
+@ void cgba_memset32(void* destination, u32 value, u32 wordCount)
+    .global cgba_memset32
+    .type cgba_memset32, %function
+cgba_memset32:
+    push    {r4-r9}
+    mov     r3, r1
+    mov     r4, r1
+    mov     r5, r1
+    mov     r6, r1
+    mov     r7, r1
+    mov     r8, r1
+    mov     r9, r1
+    movs    r12, r2, lsr #3
+    beq     .Lfill_words
+.Lfill_blocks:
+    stmia   r0!, {r1, r3-r9}
+    subs    r12, r12, #1
+    bne     .Lfill_blocks
+.Lfill_words:
+    ands    r2, r2, #7
+    beq     .Lfill_done
+.Lfill_word:
+    str     r1, [r0], #4
+    subs    r2, r2, #1
+    bne     .Lfill_word
+.Lfill_done:
+    pop     {r4-r9}
+    bx      lr
+    .size cgba_memset32, . - cgba_memset32
+
+@ void cgba_convert_tiles_16_to_256(void* destination, const void* source, u32 tileCount, u32 paletteNumber)
+@ Every source word holds 8 pixels, the left one in the low nibble, and becomes 2 words of one byte per pixel.
+@ Non zero pixels get paletteNumber * 16 added, 0 stays transparent
+    .global cgba_convert_tiles_16_to_256
+    .type cgba_convert_tiles_16_to_256, %function
+cgba_convert_tiles_16_to_256:
+    push    {r4-r8, lr}
+    movs    r2, r2, lsl #3
+    beq     .Lconvert_done
+    mov     r3, r3, lsl #4
+    ldr     r12, =0x000F000F
+    ldr     lr, =0x7F7F7F7F
+    ldr     r8, =0x80808080
+.Lconvert_word:
+    ldr     r4, [r1], #4
+
+    @ Pixels 0 to 3, spread the low halfword to bytes 0 and 2 then split the nibbles into bytes 0 to 3
+    and     r6, r4, #0xFF00
+    and     r5, r4, #0xFF
+    orr     r5, r5, r6, lsl #8
+    and     r6, r5, r12
+    and     r5, r5, r12, lsl #4
+    orr     r5, r6, r5, lsl #4
+
+    @ Bytes are at most 15 so adding 0x7F sets bit 7 of exactly the non zero ones, without carrying into the next byte
+    add     r6, r5, lr
+    and     r6, r6, r8
+    mov     r6, r6, lsr #7
+    mla     r5, r6, r3, r5
+
+    @ Pixels 4 to 7 from the high halfword
+    mov     r7, r4, lsr #16
+    and     r6, r7, #0xFF00
+    and     r7, r7, #0xFF
+    orr     r7, r7, r6, lsl #8
+    and     r6, r7, r12
+    and     r7, r7, r12, lsl #4
+    orr     r7, r6, r7, lsl #4
+
+    add     r6, r7, lr
+    and     r6, r6, r8
+    mov     r6, r6, lsr #7
+    mla     r7, r6, r3, r7
+
+    stmia   r0!, {r5, r7}
+    subs    r2, r2, #1
+    bne     .Lconvert_word
+.Lconvert_done:
+    pop     {r4-r8, lr}
+    bx      lr
+    .ltorg
+    .size cgba_convert_tiles_16_to_256, . - cgba_convert_tiles_16_to_256
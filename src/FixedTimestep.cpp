@@ -0,0 +1,50 @@
+#include "FixedTimestep.hpp"
+
+namespace cgba
+{
+    FixedTimestep::FixedTimestep(Time _tickInterval, u32 _maxTicksPerAdvance) :
+        tickInterval{ _tickInterval },
+        maxTicksPerAdvance{ _maxTicksPerAdvance }
+    {
+        CGBA_ASSERT(tickInterval.Raw() > 0, "Tick interval must be positive");
+    }
+
+    u32 FixedTimestep::Advance(Time elapsed)
+    {
+        accumulator += elapsed;
+
+        u32 ticks = 0;
+        while(accumulator >= tickInterval && ticks < maxTicksPerAdvance)
+        {
+            accumulator -= tickInterval;
+            ticks++;
+        }
+
+        if(accumulator >= tickInterval)
+        {
+            droppedTicks += accumulator.Raw() / tickInterval.Raw();
+            accumulator = Time::FromRaw(accumulator.Raw() % tickInterval.Raw());
+        }
+        return ticks;
+    }
+
+    u32 FixedTimestep::AdvanceScanlines(u32 scanlines)
+    {
+        const u32 scaled = (scanlines << 8) + scanlineRemainder;
+        scanlineRemainder = scaled % scanlinesPerFrame;
+        return Advance(Time::FromRaw(scaled / scanlinesPerFrame));
+    }
+
+    void FixedTimestep::SetTickInterval(Time interval)
+    {
+        CGBA_ASSERT(interval.Raw() > 0, "Tick interval must be positive");
+        tickInterval = interval;
+    }
+
+    void FixedTimestep::Reset()
+    {
+        accumulator = {};
+        scanlineRemainder = 0;
+        droppedTicks = 0;
+    }
+}
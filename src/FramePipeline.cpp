@@ -0,0 +1,40 @@
+#include "FramePipeline.hpp"
+
+namespace cgba
+{
+    FramePipeline::FramePipeline(Range<u32, 0, 159> _inputLine) :
+        inputLine{ _inputLine }
+    {
+
+    }
+
+    void FramePipeline::EndFrame()
+    {
+        if(!inputPending)
+            return;
+
+        //Whether the commit made it into VBlank or ran into the next frame, the result first shows at the next line 0
+        const u32 now = GetScanlineTime();
+        const u32 displayTime = now - now % scanlineCount + scanlineCount;
+        const u32 latency = displayTime - pendingInputTime;
+        inputPending = false;
+
+        stats.last = latency;
+        stats.min = (stats.count == 0 || latency < stats.min) ? latency : stats.min;
+        stats.max = latency > stats.max ? latency : stats.max;
+        stats.total += latency;
+        stats.count++;
+
+        if(latencyHook)
+            latencyHook(latency);
+    }
+
+    u32 FramePipeline::GetScanlineTime()
+    {
+        const u32 line = Display::GetVerticalCounter();
+        if(line < lastLine)
+            frame++;
+        lastLine = line;
+        return frame * scanlineCount + line;
+    }
+}
@@ -1,11 +1,17 @@
 #include "Input.hpp"
+#include "Display.hpp"
 #include <utility>
 
 namespace cgba
 {
     void BasicController::Poll()
     {
-        previous = std::exchange(current, PollInput());
+        Poll(PollInput());
+    }
+
+    void BasicController::Poll(KeyInput input)
+    {
+        previous = std::exchange(current, input);
     }
 
     WordBool BasicController::Pressed(Key key) const
@@ -20,4 +26,144 @@ namespace cgba
     {
         return WordBool{ (previous.data & ~current.data) & key }; 
     }
+
+    namespace
+    {
+        constexpr u32 scanlineCount = 228;
+        constexpr u32 maxRunLength = 0xFFFF;
+    }
+
+    InputLatch::InputLatch(Range<u32, 1, 228> sampleCount) :
+        sampleInterval{ scanlineCount / sampleCount }
+    {
+
+    }
+
+    void InputLatch::Sample()
+    {
+        const u16 input = PollInput().data;
+        if(!pressSeen && (input & ~consumed & ~latched))
+        {
+            pressSeen = true;
+            firstPressLine = Display::GetVerticalCounter();
+        }
+        latched |= input;
+    }
+
+    void InputLatch::SampleScheduled()
+    {
+        //Sampling on entering a new slot of lines also covers the counter wrapping at the end of the frame
+        const u32 slot = Display::GetVerticalCounter() / sampleInterval;
+        if(slot != lastSlot)
+        {
+            Sample();
+            lastSlot = slot;
+        }
+    }
+
+    KeyInput InputLatch::Consume()
+    {
+        Sample();
+        pressAge = pressSeen ? (Display::GetVerticalCounter() + scanlineCount - firstPressLine) % scanlineCount : 0;
+        pressSeen = false;
+        consumed = std::exchange(latched, static_cast<u16>(0));
+        return { consumed };
+    }
+
+    void InputEventQueue::Push(const InputEvent& event)
+    {
+        if(count == capacity)
+        {
+            first = (first + 1) % capacity;
+            count--;
+            dropped++;
+        }
+
+        events[(first + count) % capacity] = event;
+        count++;
+    }
+
+    void InputEventQueue::PushChanges(KeyInput previous, KeyInput current, u32 frame)
+    {
+        u16 changed = previous.data ^ current.data;
+        while(changed)
+        {
+            const u16 key = changed & -changed;
+            Push({ frame, static_cast<Key>(key), (current.data & key) ? InputEventType::Pressed : InputEventType::Released });
+            changed &= ~key;
+        }
+    }
+
+    WordBool InputEventQueue::Pop(InputEvent& event)
+    {
+        if(count == 0)
+            return false;
+
+        event = events[first];
+        first = (first + 1) % capacity;
+        count--;
+        return true;
+    }
+
+    void InputEventQueue::Clear()
+    {
+        first = 0;
+        count = 0;
+        dropped = 0;
+    }
+
+    InputRecorder::InputRecorder(u32* _runs, u32 _capacity) :
+        runs{ _runs },
+        capacity{ _capacity }
+    {
+
+    }
+
+    WordBool InputRecorder::Record(KeyInput input)
+    {
+        if(runCount > 0)
+        {
+            u32& last = runs[runCount - 1];
+            const u32 length = last >> 16;
+            if((last & 0xFFFF) == input.data && length < maxRunLength)
+            {
+                last += 1 << 16;
+                return true;
+            }
+        }
+
+        if(runCount == capacity)
+            return false;
+
+        runs[runCount++] = input.data | (1 << 16);
+        return true;
+    }
+
+    InputPlayer::InputPlayer(const u32* _runs, u32 _runCount) :
+        runs{ _runs },
+        runCount{ _runCount }
+    {
+
+    }
+
+    KeyInput InputPlayer::Next()
+    {
+        if(IsDone())
+            return {};
+
+        const KeyInput input{ static_cast<u16>(runs[run] & 0xFFFF) };
+        frameInRun++;
+        if(frameInRun == runs[run] >> 16)
+        {
+            run++;
+            frameInRun = 0;
+        }
+        return input;
+    }
+
+    void InputPlayer::Rewind()
+    {
+        run = 0;
+        frameInRun = 0;
+    }
 }
\ No newline at end of file
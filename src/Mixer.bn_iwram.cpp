@@ -0,0 +1,55 @@
+#include "Mixer.hpp"
+
+namespace cgba
+{
+    u32 Mixer::MixChannel(Channel& channel, i16* accumulator, u32 count)
+    {
+        const i8* data = channel.data;
+        const i32 volume = static_cast<i32>(channel.volume);
+        const u32 increment = channel.increment;
+        u32 position = channel.position;
+
+        u32 mixed = 0;
+        while(mixed < count)
+        {
+            //Steps left before the end, so the inner loop doesn't have to check for it
+            const u32 left = (channel.end - position + increment - 1) / increment;
+            const u32 run = left < count - mixed ? left : count - mixed;
+
+            i16* destination = accumulator + mixed;
+            for(u32 i = 0; i < run; i++)
+            {
+                //An 8 bit sample at full volume adds 1/8 of the accumulator's range, leaving room for all channels
+                destination[i] = static_cast<i16>(destination[i] + ((data[position >> fractionBits] * volume) >> 3));
+                position += increment;
+            }
+            mixed += run;
+
+            if(position < channel.end)
+                break;
+
+            if(channel.loopLength == 0)
+            {
+                channel.data = nullptr;
+                break;
+            }
+
+            while(position >= channel.end)
+                position -= channel.loopLength;
+        }
+
+        channel.position = position;
+        return mixed;
+    }
+
+    void Mixer::Resolve(i16* accumulator, i8* output, u32 count)
+    {
+        for(u32 i = 0; i < count; i++)
+        {
+            i32 value = accumulator[i] >> 3;
+            value = value < -128 ? -128 : (value > 127 ? 127 : value);
+            output[i] = static_cast<i8>(value);
+            accumulator[i] = 0;
+        }
+    }
+}
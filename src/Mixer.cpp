@@ -0,0 +1,86 @@
+#include "Mixer.hpp"
+
+namespace cgba
+{
+    Mixer::Mixer(u32 _outputRate) :
+        outputRate{ _outputRate }
+    {
+        CGBA_ASSERT(outputRate > 0);
+    }
+
+    u32 Mixer::Play(const SoundSample& sample, Range<u32, 0, maxVolume> volume, u32 rate)
+    {
+        CGBA_ASSERT(sample.length > 0 && sample.loopStart <= sample.length);
+        CGBA_ASSERT(sample.length < (1u << (32 - fractionBits)), "Sample is too long for the fixed point position");
+
+        for(u32 i = 0; i < maxChannels; i++)
+        {
+            Channel& channel = channels[i];
+            if(channel.data)
+                continue;
+
+            channel.data = sample.data;
+            channel.position = 0;
+            channel.increment = GetIncrement(rate == 0 ? sample.sampleRate : rate);
+            channel.end = sample.length << fractionBits;
+            channel.loopLength = (sample.length - sample.loopStart) << fractionBits;
+            channel.volume = volume;
+            return i;
+        }
+        return noChannel;
+    }
+
+    void Mixer::Stop(Range<u32, 0, maxChannels - 1> channel)
+    {
+        channels[channel].data = nullptr;
+    }
+
+    void Mixer::StopAll()
+    {
+        for(Channel& channel : channels)
+            channel.data = nullptr;
+    }
+
+    void Mixer::SetVolume(Range<u32, 0, maxChannels - 1> channel, Range<u32, 0, maxVolume> volume)
+    {
+        channels[channel].volume = volume;
+    }
+
+    void Mixer::SetRate(Range<u32, 0, maxChannels - 1> channel, u32 rate)
+    {
+        channels[channel].increment = GetIncrement(rate);
+    }
+
+    u32 Mixer::GetPlayingCount() const
+    {
+        u32 count = 0;
+        for(const Channel& channel : channels)
+        {
+            if(channel.data)
+                count++;
+        }
+        return count;
+    }
+
+    void Mixer::Mix(i8* output, u32 count)
+    {
+        CGBA_ASSERT(count <= maxSamplesPerMix && count % 4 == 0);
+
+        for(Channel& channel : channels)
+        {
+            if(channel.data && channel.volume > 0)
+                MixChannel(channel, accumulator.data(), count);
+        }
+
+        Resolve(accumulator.data(), output, count);
+    }
+
+    u32 Mixer::GetIncrement(u32 rate) const
+    {
+        CGBA_ASSERT(rate < (1u << (32 - fractionBits)), "Rate is too high for the fixed point increment");
+
+        //At least one step, or the sample would never advance
+        const u32 increment = (rate << fractionBits) / outputRate;
+        return increment > 0 ? increment : 1;
+    }
+}
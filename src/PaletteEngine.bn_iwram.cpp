@@ -0,0 +1,25 @@
+#include "PaletteEngine.hpp"
+
+namespace cgba
+{
+    void PaletteEngine::BlendPairs(u32* destination, const u32* source, u32 pairCount, u32 pair, u32 weight)
+    {
+        //Each mask keeps 3 of the 6 components of a color pair with at least 5 free bits above every one of them,
+        //so the weighted sums of all 3 fit in one register without carrying into each other.
+        //Red 0, blue 0 and green 1 in place, then green 0, red 1 and blue 1 after shifting the pair down 5 bits
+        constexpr u32 lowMask = 0x03E0'7C1F;
+        constexpr u32 highMask = 0x03E0'F81F;
+
+        const u32 inverseWeight = maxWeight - weight;
+        const u32 pairLow = (pair & lowMask) * weight;
+        const u32 pairHigh = ((pair >> 5) & highMask) * weight;
+
+        for(u32 i = 0; i < pairCount; i++)
+        {
+            const u32 colors = source[i];
+            const u32 low = (((colors & lowMask) * inverseWeight + pairLow) >> 5) & lowMask;
+            const u32 high = ((((colors >> 5) & highMask) * inverseWeight + pairHigh) >> 5) & highMask;
+            destination[i] = low | (high << 5);
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#include "PaletteEngine.hpp"
+#include "Dma.hpp"
+#include <utility>
+
+namespace cgba
+{
+    PaletteEngine::PaletteEngine()
+    {
+        for(u32 i = 0; i < base.size(); i++)
+            base[i] = Memory<volatile u32>(background_palettes, i);
+
+        output = base;
+    }
+
+    void PaletteEngine::SetColor(Range<u32, 0, colorCount - 1> index, RGB15 color)
+    {
+        SetHalf(base, index, color.Data());
+        SetHalf(output, index, color.Data());
+        MarkDirty(index, 1);
+    }
+
+    RGB15 PaletteEngine::GetColor(Range<u32, 0, colorCount - 1> index) const
+    {
+        return RGB15{ GetHalf(base, index) };
+    }
+
+    RGB15 PaletteEngine::GetOutputColor(Range<u32, 0, colorCount - 1> index) const
+    {
+        return RGB15{ GetHalf(output, index) };
+    }
+
+    void PaletteEngine::Blend(u32 firstIndex, u32 count, RGB15 color, Range<u32, 0, maxWeight> weight)
+    {
+        CGBA_ASSERT(firstIndex + count <= colorCount);
+        if(count == 0)
+            return;
+
+        const u32 pair = color.Data() | (static_cast<u32>(color.Data()) << 16);
+        const u32 lastIndex = firstIndex + count;
+
+        //Colors sharing a word with one outside the range are blended as a pair and only their half is kept
+        auto BlendSingle = [&](u32 index)
+        {
+            u32 blended;
+            BlendPairs(&blended, &base[index / 2], 1, pair, weight);
+            SetHalf(output, index, static_cast<u16>(blended >> ((index % 2) * 16)));
+        };
+
+        u32 index = firstIndex;
+        if(index % 2)
+            BlendSingle(index++);
+
+        const u32 pairCount = (lastIndex - index) / 2;
+        BlendPairs(&output[index / 2], &base[index / 2], pairCount, pair, weight);
+        index += pairCount * 2;
+
+        if(index < lastIndex)
+            BlendSingle(index);
+
+        MarkDirty(firstIndex, count);
+    }
+
+    void PaletteEngine::Restore(u32 firstIndex, u32 count)
+    {
+        CGBA_ASSERT(firstIndex + count <= colorCount);
+        if(count == 0)
+            return;
+
+        for(u32 i = firstIndex; i < firstIndex + count; i++)
+            SetHalf(output, i, GetHalf(base, i));
+
+        MarkDirty(firstIndex, count);
+    }
+
+    void PaletteEngine::Cycle(u32 firstIndex, u32 count, u32 steps)
+    {
+        CGBA_ASSERT(firstIndex + count <= colorCount);
+        if(count == 0 || steps % count == 0)
+            return;
+
+        //Rotating right by steps is reversing the whole range, then both parts on either side of steps
+        auto Reverse = [](std::array<u32, colorCount / 2>& colors, u32 first, u32 last)
+        {
+            while(first + 1 < last)
+            {
+                last--;
+                const u16 color = GetHalf(colors, first);
+                SetHalf(colors, first, GetHalf(colors, last));
+                SetHalf(colors, last, color);
+                first++;
+            }
+        };
+
+        const u32 split = firstIndex + steps % count;
+        for(std::array<u32, colorCount / 2>* colors : { &base, &output })
+        {
+            Reverse(*colors, firstIndex, firstIndex + count);
+            Reverse(*colors, firstIndex, split);
+            Reverse(*colors, split, firstIndex + count);
+        }
+
+        MarkDirty(firstIndex, count);
+    }
+
+    void PaletteEngine::CommitVBlank()
+    {
+        constexpr u32 wordsPerBank = colorsPerBank / 2;
+
+        //Background and object palettes are adjacent, so neighbouring banks go out in one transfer
+        u32 bank = 0;
+        while(dirtyBanks >> bank)
+        {
+            if(!((dirtyBanks >> bank) & 1))
+            {
+                bank++;
+                continue;
+            }
+
+            u32 lastBank = bank;
+            while(lastBank < 32 && ((dirtyBanks >> lastBank) & 1))
+                lastBank++;
+
+            Dma::Copy32(&output[bank * wordsPerBank], &Memory<volatile u32>(background_palettes, bank * wordsPerBank), (lastBank - bank) * wordsPerBank);
+            if(lastBank == 32)
+                break;
+            bank = lastBank;
+        }
+
+        dirtyBanks = 0;
+    }
+
+    void PaletteEngine::MarkDirty(u32 firstIndex, u32 count)
+    {
+        const u32 firstBank = firstIndex / colorsPerBank;
+        const u32 lastBank = (firstIndex + count - 1) / colorsPerBank;
+        const u32 bankCount = lastBank - firstBank + 1;
+        dirtyBanks |= (bankCount == 32 ? 0xFFFF'FFFF : ((1u << bankCount) - 1)) << firstBank;
+    }
+
+    u16 PaletteEngine::GetHalf(const std::array<u32, colorCount / 2>& colors, u32 index)
+    {
+        return static_cast<u16>(colors[index / 2] >> ((index % 2) * 16));
+    }
+
+    void PaletteEngine::SetHalf(std::array<u32, colorCount / 2>& colors, u32 index, u16 value)
+    {
+        const u32 shift = (index % 2) * 16;
+        colors[index / 2] = (colors[index / 2] & ~(0xFFFFu << shift)) | (static_cast<u32>(value) << shift);
+    }
+}
@@ -0,0 +1,204 @@
+#include "PsgPlayer.hpp"
+#include "Sound.hpp"
+#include "MemoryRegion.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        constexpr std::array<uintptr, 10> slotAddresses
+        {
+            sound1_sweep_register,
+            sound1_envelope_register,
+            sound1_frequency_register,
+            sound2_envelope_register,
+            sound2_frequency_register,
+            sound3_select_register,
+            sound3_volume_register,
+            sound3_frequency_register,
+            sound4_envelope_register,
+            sound4_frequency_register
+        };
+
+        //Hundredths of a hertz in octave 8, lower octaves halve them
+        constexpr std::array<u32, 12> octave8Frequencies
+        {
+            418601, 443492, 469863, 497803, 527404, 558765, 591991, 627193, 664488, 704000, 745862, 790213
+        };
+
+        constexpr u32 noteCount = 72;
+        constexpr u32 squareClock = 131072;
+        constexpr u32 waveClock = 65536;
+
+        constexpr u16 restart = 0x8000;
+        constexpr u16 waveEnable = 0x80;
+        constexpr u16 waveWriteBank0 = 0x40;
+    }
+
+    void PsgPlayer::Play(const PsgSong& _song)
+    {
+        CGBA_ASSERT(_song.orderLength > 0 && _song.loopOrder < _song.orderLength && _song.ticksPerRow > 0);
+
+        Sound::Enable();
+        PsgControlRegister control{};
+        control.SetVolume(7, 7);
+        control.SetChannels(PsgControlRegister::allChannels, PsgControlRegister::allChannels);
+        PsgControl::Store(control);
+        DirectSoundControl::Modify([](DirectSoundControlRegister& directSound){ directSound.SetPsgVolume(PsgMixVolume::Full); });
+
+        song = &_song;
+        orderIndex = 0;
+        rowsLeft = 0;
+        tick = 0;
+        instruments.fill(0);
+        loadedWave = unknownValue;
+        written.fill(unknownValue);
+    }
+
+    void PsgPlayer::Stop()
+    {
+        if(!song)
+            return;
+
+        for(u32 channel = 0; channel < channelCount; channel++)
+            Silence(channel);
+        song = nullptr;
+    }
+
+    void PsgPlayer::Tick()
+    {
+        writeCount = 0;
+        if(!song)
+            return;
+
+        if(tick == 0)
+            PlayRow();
+
+        if(++tick >= song->ticksPerRow)
+            tick = 0;
+    }
+
+    void PsgPlayer::StartPattern()
+    {
+        if(orderIndex >= song->orderLength)
+            orderIndex = song->loopOrder;
+
+        row = song->patterns[song->order[orderIndex++]];
+        rowsLeft = *row++;
+    }
+
+    void PsgPlayer::PlayRow()
+    {
+        while(rowsLeft == 0)
+            StartPattern();
+
+        const u32 channels = *row++;
+        for(u32 channel = 0; channel < channelCount; channel++)
+        {
+            if((channels & (1 << channel)) == 0)
+                continue;
+
+            u8 note = *row++;
+            if(note & PsgSong::instrumentFollows)
+            {
+                instruments[channel] = *row++;
+                note &= ~PsgSong::instrumentFollows;
+            }
+
+            if(note == PsgSong::noteOff)
+                Silence(channel);
+            else
+                PlayCell(channel, note, instruments[channel]);
+        }
+        rowsLeft--;
+    }
+
+    void PsgPlayer::PlayCell(u32 channel, u8 note, u32 instrumentIndex)
+    {
+        CGBA_ASSERT(instrumentIndex < song->instrumentCount, "Instrument is missing from the song");
+        const PsgInstrument& instrument = song->instruments[instrumentIndex];
+
+        switch(channel)
+        {
+        case 0:
+            Write(Slot::Sweep1, instrument.sweep);
+            Write(Slot::Envelope1, instrument.envelope);
+            Write(Slot::Frequency1, GetFrequency(note, squareClock) | restart, true);
+            break;
+
+        case 1:
+            Write(Slot::Envelope2, instrument.envelope);
+            Write(Slot::Frequency2, GetFrequency(note, squareClock) | restart, true);
+            break;
+
+        case 2:
+            LoadWave(instrument.wave & 0x1F);
+            Write(Slot::WaveEnable, waveEnable);
+            Write(Slot::WaveVolume, static_cast<u16>((instrument.wave >> 5) << 13));
+            Write(Slot::Frequency3, GetFrequency(note, waveClock) | restart, true);
+            break;
+
+        default:
+            //Shift in bits 4 to 7 and the divider ratio in bits 0 to 2 of the register, the counter width in between
+            Write(Slot::Envelope4, instrument.envelope);
+            Write(Slot::Frequency4, static_cast<u16>(((note >> 3) << 4) | (instrument.sweep & 0x8) | (note & 0x7) | restart), true);
+            break;
+        }
+    }
+
+    void PsgPlayer::Silence(u32 channel)
+    {
+        //An envelope starting at volume 0 going down turns the channel's output off
+        switch(channel)
+        {
+        case 0:
+            Write(Slot::Envelope1, 0);
+            break;
+        case 1:
+            Write(Slot::Envelope2, 0);
+            break;
+        case 2:
+            Write(Slot::WaveEnable, 0);
+            break;
+        default:
+            Write(Slot::Envelope4, 0);
+            break;
+        }
+    }
+
+    void PsgPlayer::LoadWave(u32 wave)
+    {
+        if(wave == loadedWave)
+            return;
+
+        CGBA_ASSERT(wave < song->waveCount, "Wave is missing from the song");
+
+        //The CPU accesses the bank that isn't playing, so play bank 1 while writing bank 0, which is then played
+        Write(Slot::WaveEnable, waveWriteBank0);
+        for(u32 i = 0; i < song->waves[wave].size(); i++)
+            Memory<volatile u32>(sound_wave_ram, i) = song->waves[wave][i];
+        writeCount += song->waves[wave].size();
+        loadedWave = wave;
+    }
+
+    void PsgPlayer::Write(Slot slot, u16 value, WordBool force)
+    {
+        const u32 index = static_cast<u32>(slot);
+        if(written[index] == value && !force)
+            return;
+
+        Memory<volatile u16>(slotAddresses[index]) = value;
+        written[index] = value;
+        writeCount++;
+    }
+
+    u16 PsgPlayer::GetFrequency(u8 note, u32 clock)
+    {
+        CGBA_ASSERT(note < noteCount, "Notes go from C2 to B7");
+
+        //The channel plays clock / (2048 - value) hertz
+        const u32 octave = 2 + note / 12;
+        const i32 value = 2048 - static_cast<i32>(clock * 100 * (1 << (8 - octave)) / octave8Frequencies[note % 12]);
+        return static_cast<u16>(value < 0 ? 0 : value);
+    }
+}
@@ -0,0 +1,46 @@
+#include "RenderCommands.hpp"
+#include "FastMemory.hpp"
+
+namespace cgba
+{
+    void RenderCommandBuffer::Flush()
+    {
+        constexpr u32 rowStride = screenBlockSizeTiles.width;
+
+        for(u32 i = 0; i < commandCount; i++)
+        {
+            const RenderCommand& command = commands[i];
+            switch(command.type)
+            {
+            case RenderCommandType::Write:
+                FastMemory::Copy16(command.destination, command.source, command.width);
+                break;
+
+            case RenderCommandType::Fill:
+                //Full rows are contiguous, so they are filled in one go
+                if(command.width == rowStride)
+                {
+                    FastMemory::Fill16(command.destination, command.value, rowStride * command.height);
+                    break;
+                }
+
+                for(u32 row = 0; row < command.height; row++)
+                    FastMemory::Fill16(command.destination + row * rowStride, command.value, command.width);
+                break;
+
+            case RenderCommandType::Copy:
+                if(command.width == rowStride && command.sourceStride == rowStride)
+                {
+                    FastMemory::Copy16(command.destination, command.source, rowStride * command.height);
+                    break;
+                }
+
+                for(u32 row = 0; row < command.height; row++)
+                    FastMemory::Copy16(command.destination + row * rowStride, command.source + row * command.sourceStride, command.width);
+                break;
+            }
+        }
+
+        Clear();
+    }
+}
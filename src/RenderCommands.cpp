@@ -0,0 +1,95 @@
+#include "RenderCommands.hpp"
+#include "MemoryRegion.hpp"
+
+namespace cgba
+{
+    void RenderCommandBuffer::SetTile(Range<u32, 0, 31> screenBaseBlock, Point<i16> position, TextBackgroundTileDescription tile)
+    {
+        CGBA_ASSERT(position.x >= 0 && position.y >= 0 && position.x < screenBlockSizeTiles.width && position.y < screenBlockSizeTiles.height);
+        Write(GetEntryAddress(screenBaseBlock, position), tile.data);
+    }
+
+    void RenderCommandBuffer::FillRect(Range<u32, 0, 31> screenBaseBlock, Point<i16> position, Rectangle size, TextBackgroundTileDescription tile)
+    {
+        CGBA_ASSERT(position.x >= 0 && position.y >= 0 && position.x + size.width <= screenBlockSizeTiles.width && position.y + size.height <= screenBlockSizeTiles.height);
+        volatile u16* destination = GetEntryAddress(screenBaseBlock, position);
+
+        if(commandCount > 0 && size.height == 1)
+        {
+            RenderCommand& last = commands[commandCount - 1];
+            if(last.type == RenderCommandType::Fill && last.height == 1 && last.value == tile.data && last.destination + last.width == destination
+                && last.width + size.width <= 0xFF)
+            {
+                last.width = static_cast<u8>(last.width + size.width);
+                return;
+            }
+        }
+
+        Add({ RenderCommandType::Fill, static_cast<u8>(size.width), static_cast<u8>(size.height), 0, destination, nullptr, tile.data });
+    }
+
+    void RenderCommandBuffer::CopyRect(Range<u32, 0, 31> screenBaseBlock, Point<i16> position, Rectangle size, const TextBackgroundTileDescription* source, u32 sourceStride)
+    {
+        CGBA_ASSERT(position.x >= 0 && position.y >= 0 && position.x + size.width <= screenBlockSizeTiles.width && position.y + size.height <= screenBlockSizeTiles.height);
+        CGBA_ASSERT(sourceStride <= 0xFF);
+        Add({ RenderCommandType::Copy, static_cast<u8>(size.width), static_cast<u8>(size.height), static_cast<u8>(sourceStride),
+            GetEntryAddress(screenBaseBlock, position), reinterpret_cast<const u16*>(source), 0 });
+    }
+
+    void RenderCommandBuffer::SetColor(Range<u32, 0, 511> index, RGB15 color)
+    {
+        Write(&Memory<volatile u16>(background_palettes, index), color.Data());
+    }
+
+    void RenderCommandBuffer::Clear()
+    {
+        commandCount = 0;
+        valueCount = 0;
+        droppedCount = 0;
+    }
+
+    void RenderCommandBuffer::Write(volatile u16* destination, u16 value)
+    {
+        CGBA_ASSERT(valueCount < maxValues, "Render command values are full");
+        if(valueCount == maxValues)
+        {
+            droppedCount++;
+            return;
+        }
+
+        values[valueCount] = value;
+
+        //The values of the last command always end at valueCount, so a write right after its destination extends it
+        if(commandCount > 0)
+        {
+            RenderCommand& last = commands[commandCount - 1];
+            if(last.type == RenderCommandType::Write && last.destination + last.width == destination && last.width < 0xFF)
+            {
+                last.width++;
+                valueCount++;
+                return;
+            }
+        }
+
+        if(Add({ RenderCommandType::Write, 1, 1, 0, destination, &values[valueCount], 0 }))
+            valueCount++;
+    }
+
+    WordBool RenderCommandBuffer::Add(const RenderCommand& command)
+    {
+        CGBA_ASSERT(commandCount < maxCommands, "Render commands are full");
+        if(commandCount == maxCommands)
+        {
+            droppedCount++;
+            return false;
+        }
+
+        commands[commandCount++] = command;
+        return true;
+    }
+
+    volatile u16* RenderCommandBuffer::GetEntryAddress(u32 screenBaseBlock, Point<i16> position)
+    {
+        return &Memory<volatile u16>(vram + screen_block_increments * screenBaseBlock, position.x + position.y * screenBlockSizeTiles.width);
+    }
+}
@@ -0,0 +1,164 @@
+#include "SceneManager.hpp"
+#include "MemoryRegion.hpp"
+
+namespace cgba
+{
+    void DisplayState::CaptureControl()
+    {
+        control = DisplayControl::Load();
+        for(u32 i = 0; i < backgroundCount; i++)
+            backgrounds[i] = BackgroundControl::Load(i);
+    }
+
+    void DisplayState::Apply() const
+    {
+        for(u32 i = 0; i < backgroundCount; i++)
+        {
+            BackgroundControl::Store(backgrounds[i], i);
+            BackgroundScroll::Store(scroll[i], i);
+        }
+
+        //Written last so newly shown layers already point at their own data
+        DisplayControl::Store(control);
+    }
+
+    SceneManager::SceneManager(SceneContext& _context) :
+        context{ _context }
+    {
+        live.CaptureControl();
+        live.Apply();
+    }
+
+    void SceneManager::Run(Scene& first)
+    {
+        Push(first);
+        while(true)
+            RunFrame();
+    }
+
+    void SceneManager::RunFrame()
+    {
+        context.controller.Poll(context.pipeline.SampleInput(context.inputLatch));
+
+        Scene* top = GetTop();
+        if(top)
+            top->Update(*this);
+
+        if(IsSwitching() && !entered && context.loader.IsIdle())
+            PrepareSwitch();
+
+        //Preloads decompress in whatever is left of the frame
+        context.loader.Update();
+
+        context.pipeline.WaitForVBlank([&]{ context.inputLatch.SampleScheduled(); });
+        context.sound.CommitVBlank();
+        context.music.Tick();
+        if(top)
+            top->CommitVBlank();
+
+        //The next scene commits in the same VBlank, so edits queued in Enter or Resume show up together with its registers
+        if(entered)
+        {
+            SwitchVBlank();
+            GetTop()->CommitVBlank();
+        }
+
+        context.palette.CommitVBlank();
+        context.loader.CommitVBlank();
+        context.tasks.RunVBlank();
+
+        //Mixing doesn't need VBlank, so it goes after everything that does
+        context.sound.Mix();
+        context.pipeline.EndFrame();
+    }
+
+    WordBool SceneManager::Push(Scene& scene)
+    {
+        CGBA_ASSERT(depth < maxDepth, "Scene stack is full");
+        if(depth == maxDepth)
+            return false;
+
+        return Request(Transition::Push, &scene);
+    }
+
+    WordBool SceneManager::Replace(Scene& scene)
+    {
+        CGBA_ASSERT(depth > 0, "No scene to replace");
+        if(depth == 0)
+            return false;
+
+        return Request(Transition::Replace, &scene);
+    }
+
+    WordBool SceneManager::Pop()
+    {
+        CGBA_ASSERT(depth > 1, "Popping would leave no scene to run");
+        if(depth <= 1)
+            return false;
+
+        return Request(Transition::Pop, stack[depth - 2]);
+    }
+
+    WordBool SceneManager::Request(Transition _transition, Scene* scene)
+    {
+        if(IsSwitching())
+            return false;
+
+        transition = _transition;
+        next = scene;
+        entered = false;
+
+        //A scene returning from under another one kept its assets
+        if(transition != Transition::Pop)
+            next->Preload();
+
+        return true;
+    }
+
+    void SceneManager::PrepareSwitch()
+    {
+        //Scenes may have changed control registers directly while running, start from what is displayed
+        pending = live;
+        pending.CaptureControl();
+
+        if(transition == Transition::Pop)
+            next->Resume(pending);
+        else
+            next->Enter(pending);
+
+        entered = true;
+    }
+
+    void SceneManager::SwitchVBlank()
+    {
+        pending.Apply();
+        live = pending;
+
+        Scene* previous = GetTop();
+        switch(transition)
+        {
+        case Transition::Push:
+            if(previous)
+                previous->Suspend();
+            stack[depth++] = next;
+            break;
+
+        case Transition::Replace:
+            previous->Exit();
+            stack[depth - 1] = next;
+            break;
+
+        case Transition::Pop:
+            previous->Exit();
+            depth--;
+            break;
+
+        case Transition::None:
+            break;
+        }
+
+        transition = Transition::None;
+        next = nullptr;
+        entered = false;
+    }
+}
@@ -1,169 +1,305 @@
 #include "SnakeScene.hpp"
 #include "Input.hpp"
 #include "Display.hpp"
+#include "cgba_snake_tiles.hpp"
+#include "cgba_font.hpp"
 #include <bn_random.h>
 #include <utility>
 
 extern bn::random defaultRandomGenerator;
 namespace 
 {
-    using BackgroundView = cgba::StaticTileBackgroundView<cgba::TextScreenSizeMode::W256_H256, cgba::PaletteMode::Color256_Palette1>;
-    
-    constexpr cgba::u32 moveDelay = 5;
+    using Time = cgba::FixedTimestep::Time;
+
+    //The snake speeds up with every apple until it moves every minMoveInterval frames
+    constexpr Time startMoveInterval = Time::FromInt(6);
+    constexpr Time minMoveInterval = Time::FromInt(2);
+    constexpr Time moveIntervalDecrease = Time::FromFraction(1, 4);
+    constexpr cgba::u32 startSize = 4;
     constexpr cgba::u32 sizeIncrease = 4;
+    constexpr cgba::u32 gameOverFadeFrames = 16;
+    constexpr cgba::u32 gameOverBrightness = cgba::ScreenFade::maxBrightness / 2;
 
-    void Initialize(SnakeGameState& state, BackgroundView snakeBuffer, BackgroundView appleBuffer);
-    void RecordNewDirection(const cgba::BasicController& controller, cgba::Point<cgba::i16>& direction);
-    void ConsumeDirection(cgba::Point<cgba::i16>& newDirection, SnakeGameState& state);
-    void UpdateAndRender(SnakeGameState& state, BackgroundView snakeBuffer, BackgroundView appleBuffer);
-    cgba::WordBool IsGameOver(const SnakeGameState& state);
+    constexpr cgba::TileFont hudFont{ cgba::graphics::font::tiles };
+    constexpr cgba::u32 hudLayer = 2;
+    constexpr cgba::u32 scoreDigits = 4;
+    constexpr cgba::Point<cgba::i16> scorePosition{ 1, 0 };
+    constexpr cgba::Point<cgba::i16> lengthPosition{ 21, 0 };
+    static_assert(scorePosition.y < SnakeDirectionBoard::firstPlayableRow && lengthPosition.y < SnakeDirectionBoard::firstPlayableRow);
+
+    //A square wave rising in pitch while it fades out, made here as there are no sound assets yet
+    constexpr cgba::u32 eatSoundRate = cgba::DirectSound::GetSampleRate(cgba::DirectSoundRate::Hz18157);
+    constexpr auto eatSoundData = []
+    {
+        std::array<cgba::i8, 2048> data{};
+        for(cgba::u32 i = 0; i < data.size(); i++)
+        {
+            const cgba::u32 halfPeriod = 12 - i * 6 / data.size();
+            const cgba::i32 amplitude = static_cast<cgba::i32>(96 * (data.size() - i) / data.size());
+            data[i] = static_cast<cgba::i8>((i / halfPeriod) % 2 == 0 ? amplitude : -amplitude);
+        }
+        return data;
+    }();
+    constexpr cgba::SoundSample eatSound{ eatSoundData.data(), eatSoundData.size(), eatSoundRate, eatSoundData.size() };
 
-    constexpr cgba::u32 emptyTile = 0;
-    constexpr cgba::u32 snakeTile = 1;
-    constexpr cgba::u32 appleTile = 2;
+    void Initialize(SnakeGameState& state, cgba::u32 snakeBlock, cgba::u32 appleBlock, cgba::RenderCommandBuffer& commands);
+    void RecordNewDirection(const cgba::BasicController& controller, SnakeGameState& state);
+    void ConsumeDirection(SnakeGameState& state);
+    void UpdateAndRender(SnakeGameState& state, cgba::u32 snakeBlock, cgba::u32 appleBlock, cgba::RenderCommandBuffer& commands);
+    cgba::WordBool IsOnBoard(cgba::Point<cgba::i16> position);
+    cgba::WordBool IsGameOver(const SnakeGameState& state);
+    cgba::u32 GetApplesEaten(const SnakeGameState& state);
+    Time GetMoveInterval(const SnakeGameState& state);
 }
 
-void SnakeScene()
+cgba::VramHandle AcquireSnakeTiles(cgba::SceneContext& context)
 {
-    cgba::BackgroundMode0& backgroundMode = cgba::Display::SetBackgroundMode<cgba::BackgroundMode0>();
-    BackgroundView background0 = backgroundMode.MakeStaticBackground0<cgba::TextScreenSizeMode::W256_H256, cgba::PaletteMode::Color256_Palette1>();
-    BackgroundView background1 = backgroundMode.MakeStaticBackground1<cgba::TextScreenSizeMode::W256_H256, cgba::PaletteMode::Color256_Palette1>();
-    background0.Show();
-    background0.SetPriority(1);
-    background1.Show();
+    const auto& snakeTiles = cgba::graphics::snake_tiles::tiles;
+    cgba::VramHandle tiles = context.vram.Find(&snakeTiles);
+    if(tiles.IsValid())
+    {
+        context.vram.Retain(tiles);
+        return tiles;
+    }
 
+    tiles = context.vram.AllocateBackgroundTiles(0, snakeTiles.size(), cgba::PaletteMode::Color256_Palette1, &snakeTiles);
+    CGBA_ASSERT(tiles.IsValid());
+    CGBA_ASSERT(context.vram.GetFirstTile(tiles) == SnakeTiles::empty, "Tile constants expect the snake tiles at the start of the character block");
+    context.loader.QueueCopy(snakeTiles, cgba::CharacterBlockView256{ 0 }, context.vram.GetFirstTile(tiles));
+    return tiles;
+}
 
-    background0.SetScreenBaseBlock(1);
-    background0.SetCharacterBaseBlock(0);
+void SetUpSnakeBackground(cgba::BackgroundControlRegister& background, cgba::u32 screenBaseBlock, cgba::u32 priority)
+{
+    background.SetScreenSizeText(cgba::TextScreenSizeMode::W256_H256);
+    background.SetPaletteMode(cgba::PaletteMode::Color256_Palette1);
+    background.SetCharacterBaseBlock(0);
+    background.SetScreenBaseBlock(screenBaseBlock);
+    background.SetPriority(priority);
+}
 
-    background1.SetScreenBaseBlock(2);
-    background1.SetCharacterBaseBlock(0);
-    
+SnakeHud::SnakeHud(cgba::u32 characterBlock, cgba::u32 firstTile, cgba::u32 screenBaseBlock) :
+    glyphs{ hudFont, characterBlock, firstTile + 1, glyphSlots },
+    scoreCaption{ glyphs, screenBaseBlock, scorePosition, 5, paletteNumber },
+    score{ glyphs, screenBaseBlock, { static_cast<cgba::i16>(scorePosition.x + 6), scorePosition.y }, scoreDigits, paletteNumber },
+    length{ hudFont, characterBlock, firstTile + 1 + glyphSlots, lengthTiles, screenBaseBlock, lengthPosition, paletteNumber }
+{
+    cgba::CharacterBlockView16{ characterBlock }.Fill(firstTile, 1);
     
-    cgba::PaletteView256 paletteBlockView = background0.GetPalette();
-    paletteBlockView[1] = cgba::RGB15(31, 31, 31);
-    paletteBlockView[2] = cgba::RGB15(31, 0, 0);
-
-    cgba::CharacterBlockView256 blockData = background0.GetCharacterBlockData();
-    blockData[0].data =
+    //Leaves the cells of the length label, which point at its own tiles
+    cgba::TextScreenBlockView screen{ screenBaseBlock };
+    for(cgba::i16 y = 0; y < SnakeDirectionBoard::boardSize.height; y++)
     {
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0
-    };
-    blockData[1].data =
+        for(cgba::i16 x = 0; x < cgba::screenBlockSizeTiles.width; x++)
+        {
+            if(y != lengthPosition.y || x < lengthPosition.x || x >= lengthPosition.x + static_cast<cgba::i16>(lengthTiles))
+                screen[{ x, y }] = cgba::TextBackgroundTileDescription{ firstTile, false, false, paletteNumber };
+        }
+    }
+
+    scoreCaption.Set("SCORE");
+}
+
+void SnakeHud::Update(cgba::u32 applesEaten, cgba::u32 snakeLength)
+{
+    if(applesEaten != shownScore)
     {
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1
-    };
-    blockData[2].data =
+        score.SetNumber(applesEaten, scoreDigits);
+        shownScore = applesEaten;
+    }
+
+    if(snakeLength != shownLength)
     {
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2
-    };
-    cgba::BasicController controller;
-
-    while(true)
+        constexpr std::string_view caption = "LENGTH ";
+        std::array<char, cgba::ProportionalTextLabel::maxLength> text;
+        std::copy(caption.begin(), caption.end(), text.begin());
+        const cgba::u32 digits = cgba::FormatDecimal(snakeLength, text.data() + caption.size(), text.size() - caption.size());
+        length.Set({ text.data(), caption.size() + digits });
+        shownLength = snakeLength;
+    }
+}
+
+void SnakeHud::CommitVBlank()
+{
+    scoreCaption.CommitVBlank();
+    score.CommitVBlank();
+    length.CommitVBlank();
+}
+
+void GameOverScene::Enter(cgba::DisplayState& /*display*/)
+{
+    fade.Start(cgba::BlendEffect::Darken, gameOverFadeFrames, gameOverBrightness);
+}
+
+void GameOverScene::Exit()
+{
+    fade.Stop();
+}
+
+void GameOverScene::Update(cgba::SceneManager& scenes)
+{
+    if(context.controller.Pressed(cgba::Key::A))
+        scenes.Pop();
+}
+
+void GameOverScene::CommitVBlank()
+{
+    fade.Update();
+}
+
+SnakeScene::SnakeScene(cgba::SceneContext& _context, GameOverScene& _gameOver) :
+    cgba::Scene{ _context },
+    gameOver{ _gameOver },
+    moveTimestep{ startMoveInterval, maxMovesPerFrame }
+{
+
+}
+
+void SnakeScene::Preload()
+{
+    tiles = AcquireSnakeTiles(context);
+    snakeMap = context.vram.AllocateScreenBlocks(cgba::TextScreenSizeMode::W256_H256);
+    appleMap = context.vram.AllocateScreenBlocks(cgba::TextScreenSizeMode::W256_H256);
+    hudMap = context.vram.AllocateScreenBlocks(cgba::TextScreenSizeMode::W256_H256);
+    hudTiles = context.vram.AllocateBackgroundTiles(1, SnakeHud::tileCount, cgba::PaletteMode::Color16_Palette16);
+    CGBA_ASSERT(snakeMap.IsValid() && appleMap.IsValid() && hudMap.IsValid() && hudTiles.IsValid());
+}
+
+void SnakeScene::Enter(cgba::DisplayState& display)
+{
+    stateMemory.emplace(cgba::MemoryArenas::Iwram());
+    state = cgba::MemoryArenas::Iwram().New<SnakeGameState>();
+    CGBA_ASSERT(state, "IWRAM arena can't hold the game state");
+
+    context.palette.Load(cgba::graphics::snake_tiles::palette);
+    context.palette.Load(cgba::graphics::font::palette, SnakeHud::paletteNumber * cgba::PaletteEngine::colorsPerBank);
+    hud.emplace(1, context.vram.GetFirstTile(hudTiles), context.vram.GetScreenBaseBlock(hudMap));
+    StartRound();
+
+    display.control.SetBackgroundMode(cgba::BackgroundMode0::modeValue);
+    SetUpSnakeBackground(display.backgrounds[0], context.vram.GetScreenBaseBlock(snakeMap), 1);
+    SetUpSnakeBackground(display.backgrounds[1], context.vram.GetScreenBaseBlock(appleMap), 0);
+
+    cgba::BackgroundControlRegister& hudBackground = display.backgrounds[hudLayer];
+    hudBackground.SetScreenSizeText(cgba::TextScreenSizeMode::W256_H256);
+    hudBackground.SetPaletteMode(cgba::PaletteMode::Color16_Palette16);
+    hudBackground.SetCharacterBaseBlock(1);
+    hudBackground.SetScreenBaseBlock(context.vram.GetScreenBaseBlock(hudMap));
+    hudBackground.SetPriority(0);
+
+    for(cgba::u32 layer = 0; layer < cgba::DisplayState::backgroundCount; layer++)
     {
-        SnakeGameState state; 
-        cgba::u32 moveTimer = moveDelay;
-        cgba::WordBool playing = true;
-        cgba::Point<cgba::i16> lastInputDirection{};
+        if(layer <= hudLayer)
+            display.control.ShowBackground(layer);
+        else
+            display.control.HideBackground(layer);
+    }
+}
 
-        Initialize(state, background0, background1);
-        while(true)
-        {
-            controller.Poll();
-            
-            if(playing)
-            {
-                RecordNewDirection(controller, lastInputDirection);
-
-                if(moveTimer == 0)
-                {
-                    moveTimer = moveDelay;
-                    ConsumeDirection(lastInputDirection, state);
-                    UpdateAndRender(state, background0, background1);
-                    playing = !IsGameOver(state);
-                }
-                
-                moveTimer--;
-            }
-            else
-            {
-                if(controller.Pressed(cgba::Key::A))
-                    break;
-            }
-
-            cgba::BadPresent();
-        }
+void SnakeScene::Exit()
+{
+    hud.reset();
+    context.vram.Release(hudTiles);
+    context.vram.Release(hudMap);
+    context.vram.Release(appleMap);
+    context.vram.Release(snakeMap);
+    context.vram.Release(tiles);
+    state = nullptr;
+    stateMemory.reset();
+}
+
+void SnakeScene::Resume(cgba::DisplayState& /*display*/)
+{
+    StartRound();
+}
+
+void SnakeScene::Update(cgba::SceneManager& scenes)
+{
+    //Real time since the last frame, a frame that missed VBlank counts double and the snake catches up
+    const cgba::u32 frameTime = context.pipeline.GetScanlineTime();
+    const cgba::u32 moves = moveTimestep.AdvanceScanlines(frameTime - lastFrameTime);
+    lastFrameTime = frameTime;
+
+    if(!playing)
+        return;
+
+    const cgba::u32 applesEaten = GetApplesEaten(*state);
+    RecordNewDirection(context.controller, *state);
+    for(cgba::u32 i = 0; i < moves && playing; i++)
+    {
+        ConsumeDirection(*state);
+        UpdateAndRender(*state, GetSnakeScreenBlock(), GetAppleScreenBlock(), renderCommands);
+        moveTimestep.SetTickInterval(GetMoveInterval(*state));
+        playing = !IsGameOver(*state);
     }
+
+    if(GetApplesEaten(*state) != applesEaten)
+        context.sound.GetMixer().Play(eatSound);
+
+    hud->Update(GetApplesEaten(*state), state->board.occupiedSpaceCount);
+
+    //The board stays up below the game over scene
+    if(!playing)
+        scenes.Push(gameOver);
+}
+
+void SnakeScene::CommitVBlank()
+{
+    renderCommands.Flush();
+    hud->CommitVBlank();
+}
+
+void SnakeScene::StartRound()
+{
+    *state = SnakeGameState{};
+    renderCommands.Clear();
+    Initialize(*state, GetSnakeScreenBlock(), GetAppleScreenBlock(), renderCommands);
+
+    moveTimestep.SetTickInterval(startMoveInterval);
+    moveTimestep.Reset();
+    lastFrameTime = context.pipeline.GetScanlineTime();
+    playing = true;
 }
 
 namespace
 {
-    void Initialize(SnakeGameState &state, BackgroundView snakeBuffer, BackgroundView appleBuffer)
+    void Initialize(SnakeGameState &state, cgba::u32 snakeBlock, cgba::u32 appleBlock, cgba::RenderCommandBuffer& commands)
     {
-        auto ClearBuffer = [](BackgroundView buffer)
-        {
-            for(cgba::i32 i = 0; i < cgba::Area(buffer.GetTileScreenSize()); i++)
-            {
-                buffer.GetScreenBlockData()[i].SetTileNumber(emptyTile);
-                buffer.GetScreenBlockData()[i].SetPaletteNumber(0);
-            }
-        };
-
-        ClearBuffer(snakeBuffer);
-        ClearBuffer(appleBuffer);
+        commands.FillRect(snakeBlock, { 0, 0 }, cgba::screenBlockSizeTiles, { SnakeTiles::empty, false, false, 0 });
+        commands.FillRect(appleBlock, { 0, 0 }, cgba::screenBlockSizeTiles, { SnakeTiles::empty, false, false, 0 });
 
-        state.snake.maxSize = 4;
+        state.snake.maxSize = startSize;
         state.snake.headPosition = state.snake.tailPosition = {7, 10};
         state.applePosition = { 15, 10 };
         state.snakeMovementDirection = {1, 0};
         state.board.occupiedSpaceCount = 1;
-        snakeBuffer.GetScreenBlockData()[state.snake.headPosition].SetTileNumber(snakeTile);
-        appleBuffer.GetScreenBlockData()[state.applePosition].SetTileNumber(appleTile);
+        commands.SetTile(snakeBlock, state.snake.headPosition, { SnakeTiles::snake, false, false, 0 });
+        commands.SetTile(appleBlock, state.applePosition, { SnakeTiles::apple, false, false, 0 });
     }
 
-    void RecordNewDirection(const cgba::BasicController &controller, cgba::Point<cgba::i16>& direction)
+    //Several presses in one frame are queued in a fixed order, each one validated against the turn before it
+    void RecordNewDirection(const cgba::BasicController &controller, SnakeGameState& state)
     {
-        if(controller.Pressed(cgba::Key::Right))
-            direction = {1, 0};
-        else if(controller.Pressed(cgba::Key::Left))
-            direction = {-1, 0};
-        else if(controller.Pressed(cgba::Key::Up))
-            direction = {0, -1};
-        else if(controller.Pressed(cgba::Key::Down))
-            direction = {0, 1};
+        constexpr std::pair<cgba::Key, cgba::Point<cgba::i16>> directionKeys[] = {
+            { cgba::Key::Right, { 1, 0 } },
+            { cgba::Key::Left, { -1, 0 } },
+            { cgba::Key::Up, { 0, -1 } },
+            { cgba::Key::Down, { 0, 1 } }
+        };
+
+        for(const auto& [key, direction] : directionKeys)
+        {
+            if(controller.Pressed(key))
+                state.directionQueue.Push(direction, state.snakeMovementDirection);
+        }
     }
 
-    void ConsumeDirection(cgba::Point<cgba::i16>& newDirection, SnakeGameState &state)
+    void ConsumeDirection(SnakeGameState &state)
     {
-        if((state.snakeMovementDirection.x != 0 && newDirection.y != 0)
-            || (state.snakeMovementDirection.y != 0 && newDirection.x != 0))
-            state.snakeMovementDirection = newDirection;
-
-        newDirection = {};
+        state.directionQueue.Pop(state.snakeMovementDirection);
     }
 
-    void UpdateAndRender(SnakeGameState &state, BackgroundView snakeBuffer, BackgroundView appleBuffer)
+    void UpdateAndRender(SnakeGameState &state, cgba::u32 snakeBlock, cgba::u32 appleBlock, cgba::RenderCommandBuffer& commands)
     {
         state.board.DirectionAt(state.snake.headPosition) = state.snakeMovementDirection;
         state.snake.headPosition += state.snakeMovementDirection;
@@ -171,12 +307,12 @@ namespace
         if(state.snake.headPosition == state.applePosition)
         {
             state.snake.maxSize += sizeIncrease;
-            appleBuffer.GetScreenBlockData()[state.applePosition].SetTileNumber(emptyTile);
-            auto value = defaultRandomGenerator.get_unbiased_int(cgba::Area(SnakeDirectionBoard::boardSize));
+            commands.SetTile(appleBlock, state.applePosition, { SnakeTiles::empty, false, false, 0 });
+            auto value = defaultRandomGenerator.get_unbiased_int(SnakeDirectionBoard::playableCells);
             state.applePosition = { 
                 static_cast<cgba::i16>(value % SnakeDirectionBoard::boardSize.width), 
-                static_cast<cgba::i16>(value / SnakeDirectionBoard::boardSize.width)};
-            appleBuffer.GetScreenBlockData()[state.applePosition].SetTileNumber(appleTile);
+                static_cast<cgba::i16>(SnakeDirectionBoard::firstPlayableRow + value / SnakeDirectionBoard::boardSize.width)};
+            commands.SetTile(appleBlock, state.applePosition, { SnakeTiles::apple, false, false, 0 });
         }
 
         if(state.board.occupiedSpaceCount < state.snake.maxSize)
@@ -186,19 +322,40 @@ namespace
         else
         {
             auto tailDirection = std::exchange(state.board.DirectionAt(state.snake.tailPosition), cgba::Point<cgba::i16>{});
-            snakeBuffer.GetScreenBlockData()[state.snake.tailPosition].SetTileNumber(emptyTile);
+            commands.SetTile(snakeBlock, state.snake.tailPosition, { SnakeTiles::empty, false, false, 0 });
             state.snake.tailPosition += tailDirection;
         }
 
-        snakeBuffer.GetScreenBlockData()[state.snake.headPosition].SetTileNumber(snakeTile);
+        //A head that left the board ends the round, there is no cell to draw it in
+        if(IsOnBoard(state.snake.headPosition))
+            commands.SetTile(snakeBlock, state.snake.headPosition, { SnakeTiles::snake, false, false, 0 });
+    }
+
+    cgba::WordBool IsOnBoard(cgba::Point<cgba::i16> position)
+    {
+        return position.x >= 0 && position.x < SnakeDirectionBoard::boardSize.width
+            && position.y >= SnakeDirectionBoard::firstPlayableRow && position.y < SnakeDirectionBoard::boardSize.height;
     }
 
     cgba::WordBool IsGameOver(const SnakeGameState &state)
     {
+        //Checked first so the board is never read outside its bounds
+        if(!IsOnBoard(state.snake.headPosition))
+            return true;
+
         const cgba::WordBool selfCollided = state.board.DirectionAt(state.snake.headPosition).MagnitudeSquared() > 0;
-        const cgba::WordBool gameWon = state.board.occupiedSpaceCount == state.board.board.size();
-        const cgba::WordBool outOfBounds = state.snake.headPosition.x < 0 || state.snake.headPosition.x >= cgba::Display::hardwareScreenSizePixels.width / cgba::tileSizePixels.width
-            ||  state.snake.headPosition.y < 0 || state.snake.headPosition.y >= cgba::Display::hardwareScreenSizePixels.height / cgba::tileSizePixels.height;
-        return  selfCollided || outOfBounds || gameWon;
+        const cgba::WordBool gameWon = state.board.occupiedSpaceCount == SnakeDirectionBoard::playableCells;
+        return  selfCollided || gameWon;
+    }
+
+    cgba::u32 GetApplesEaten(const SnakeGameState &state)
+    {
+        return (state.snake.maxSize - startSize) / sizeIncrease;
+    }
+
+    Time GetMoveInterval(const SnakeGameState &state)
+    {
+        const Time decrease = moveIntervalDecrease * GetApplesEaten(state);
+        return (startMoveInterval - minMoveInterval > decrease) ? startMoveInterval - decrease : minMoveInterval;
     }
 }
\ No newline at end of file
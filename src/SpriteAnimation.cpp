@@ -0,0 +1,99 @@
+#include "SpriteAnimation.hpp"
+#include "Dma.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        u32 GetFrameSize(const AnimationSheet& sheet)
+        {
+            const u32 tileSize = sheet.mode == PaletteMode::Color16_Palette16 ?
+                sizeof(CharacterTileTemplate<PaletteMode::Color16_Palette16, false>) :
+                sizeof(CharacterTileTemplate<PaletteMode::Color256_Palette1, false>);
+            return sheet.tilesPerFrame * tileSize;
+        }
+    }
+
+    WordBool SpriteAnimation::Allocate(VramAllocator& vram, const AnimationSheet& _sheet)
+    {
+        CGBA_ASSERT(!slot.IsValid(), "Animation already has a slot");
+        CGBA_ASSERT(_sheet.tilesPerFrame > 0);
+
+        //Not relocatable, defragmenting would move the tiles away from the number written in the object attributes
+        slot = vram.AllocateObjectTiles(_sheet.tilesPerFrame, _sheet.mode);
+        if(!slot.IsValid())
+            return false;
+
+        sheet = &_sheet;
+        slotAddress = vram.GetAddress(slot);
+        firstTile = vram.GetFirstTile(slot);
+        uploadedFrame = noFrame;
+        return true;
+    }
+
+    void SpriteAnimation::Release(VramAllocator& vram)
+    {
+        if(!slot.IsValid())
+            return;
+
+        vram.Release(slot);
+        slot = {};
+        slotAddress = nullptr;
+        sheet = nullptr;
+        clip = nullptr;
+    }
+
+    void SpriteAnimation::Play(const AnimationClip& _clip, WordBool restart)
+    {
+        CGBA_ASSERT(_clip.frameCount > 0);
+
+        if(clip == &_clip && !restart)
+            return;
+
+        clip = &_clip;
+        position = {};
+        finished = false;
+    }
+
+    void SpriteAnimation::Stop()
+    {
+        clip = nullptr;
+        finished = false;
+    }
+
+    void SpriteAnimation::Update()
+    {
+        if(!clip || finished)
+            return;
+
+        position += clip->rate * speed;
+
+        const Rate length = Rate::FromInt(clip->frameCount);
+        if(position < length)
+            return;
+
+        if(clip->loop)
+        {
+            position = Rate::FromRaw(position.Raw() % length.Raw());
+        }
+        else
+        {
+            position = Rate::FromInt(clip->frameCount - 1);
+            finished = true;
+        }
+    }
+
+    void SpriteAnimation::CommitVBlank()
+    {
+        if(!clip || !slot.IsValid())
+            return;
+
+        const u32 frame = clip->frames[position.ToInt()];
+        if(frame == uploadedFrame)
+            return;
+
+        const u32 frameSize = GetFrameSize(*sheet);
+        Dma::Copy(static_cast<const u8*>(sheet->tiles) + frame * frameSize, slotAddress, frameSize);
+        uploadedFrame = frame;
+    }
+}
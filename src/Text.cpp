@@ -0,0 +1,235 @@
+#include "Text.hpp"
+#include "FastMemory.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        constexpr u32 tileWords = sizeof(CharacterTile16) / sizeof(u32);
+    }
+
+    u32 TileFont::MeasureWidth(std::string_view text) const
+    {
+        u32 width = 0;
+        for(const char character : text)
+            width += GetWidth(GetGlyphIndex(character));
+        return width;
+    }
+
+    u32 FormatDecimal(u32 value, char* buffer, u32 bufferSize, u32 minDigits)
+    {
+        //Enough for the 10 digits of the largest u32
+        std::array<char, 10> digits;
+        u32 count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while(value > 0 && count < digits.size());
+
+        while(count < minDigits && count < digits.size())
+            digits[count++] = '0';
+
+        const u32 written = std::min(count, bufferSize);
+        for(u32 i = 0; i < written; i++)
+            buffer[i] = digits[count - 1 - i];
+        return written;
+    }
+
+    GlyphCache::GlyphCache(const TileFont& _font, Range<u32, 0, 3> characterBlock, u32 _firstTile, Range<u32, 1, maxSlots> _slotCount) :
+        font{ _font },
+        block{ characterBlock },
+        firstTile{ _firstTile },
+        slotCount{ _slotCount }
+    {
+        glyphSlots.fill(noSlot);
+        slotGlyphs.fill(noGlyph);
+        useCounts.fill(0);
+        lastUsed.fill(0);
+    }
+
+    u32 GlyphCache::Acquire(char character)
+    {
+        const u32 glyph = font.GetGlyphIndex(character);
+        clock++;
+
+        u32 slot = glyphSlots[glyph];
+        if(slot == noSlot)
+        {
+            //Empty slots have a lastUsed of 0 so they are taken first
+            for(u32 i = 0; i < slotCount; i++)
+            {
+                if(useCounts[i] == 0 && (slot == noSlot || lastUsed[i] < lastUsed[slot]))
+                    slot = i;
+            }
+            CGBA_ASSERT(slot != noSlot, "Every glyph cache slot is on screen");
+
+            if(slotGlyphs[slot] != noGlyph)
+                glyphSlots[slotGlyphs[slot]] = noSlot;
+
+            slotGlyphs[slot] = static_cast<u8>(glyph);
+            glyphSlots[glyph] = static_cast<u8>(slot);
+            FastMemory::Copy32(&block[firstTile + slot], &font.GetGlyph(glyph), tileWords);
+            misses++;
+        }
+
+        useCounts[slot]++;
+        lastUsed[slot] = clock;
+        return firstTile + slot;
+    }
+
+    void GlyphCache::Release(char character)
+    {
+        const u32 slot = glyphSlots[font.GetGlyphIndex(character)];
+        CGBA_ASSERT(slot != noSlot && useCounts[slot] > 0, "Releasing a glyph that wasn't acquired");
+        useCounts[slot]--;
+    }
+
+    TextLabel::TextLabel(GlyphCache& _cache, Range<u32, 0, 31> screenBaseBlock, Point<i16> _position, Range<u32, 1, maxLength> _length, Range<u32, 0, 15> _paletteNumber) :
+        cache{ _cache },
+        screen{ screenBaseBlock },
+        position{ _position },
+        length{ _length },
+        paletteNumber{ _paletteNumber }
+    {
+        //The first commit clears the cells
+        text.fill(' ');
+        dirty = true;
+    }
+
+    TextLabel::~TextLabel()
+    {
+        for(u32 i = 0; i < length; i++)
+        {
+            if(shown[i] != '\0')
+                cache.Release(shown[i]);
+        }
+    }
+
+    void TextLabel::Set(std::string_view value)
+    {
+        for(u32 i = 0; i < length; i++)
+        {
+            const char character = i < value.size() ? value[i] : ' ';
+            if(text[i] != character)
+            {
+                text[i] = character;
+                dirty = true;
+            }
+        }
+    }
+
+    void TextLabel::SetNumber(u32 value, u32 minDigits)
+    {
+        std::array<char, maxLength> buffer;
+        Set({ buffer.data(), FormatDecimal(value, buffer.data(), length, minDigits) });
+    }
+
+    void TextLabel::CommitVBlank()
+    {
+        if(!dirty)
+            return;
+
+        for(u32 i = 0; i < length; i++)
+        {
+            if(text[i] == shown[i])
+                continue;
+
+            //Released first so a full cache can reuse the slot
+            if(shown[i] != '\0')
+                cache.Release(shown[i]);
+
+            const Point<i16> cell{ static_cast<i16>(position.x + i), position.y };
+            screen[cell] = TextBackgroundTileDescription{ cache.Acquire(text[i]), false, false, paletteNumber };
+            shown[i] = text[i];
+        }
+        dirty = false;
+    }
+
+    ProportionalTextLabel::ProportionalTextLabel(const TileFont& _font, Range<u32, 0, 3> characterBlock, u32 _firstTile, Range<u32, 1, maxTiles> _tileCount,
+        Range<u32, 0, 31> screenBaseBlock, Point<i16> position, Range<u32, 0, 15> paletteNumber) :
+        font{ _font },
+        block{ characterBlock },
+        firstTile{ _firstTile },
+        tileCount{ _tileCount }
+    {
+        TextScreenBlockView screen{ screenBaseBlock };
+        for(u32 i = 0; i < tileCount; i++)
+            screen[{ static_cast<i16>(position.x + i), position.y }] = TextBackgroundTileDescription{ firstTile + i, false, false, paletteNumber };
+
+        FastMemory::Fill32(&block[firstTile], 0, tileCount * tileWords);
+    }
+
+    void ProportionalTextLabel::Set(std::string_view value)
+    {
+        const u32 newLength = std::min<u32>(value.size(), maxLength);
+        u32 difference = 0;
+        while(difference < newLength && difference < length && text[difference] == value[difference])
+            difference++;
+
+        if(difference == newLength && newLength == length)
+            return;
+
+        for(u32 i = difference; i < newLength; i++)
+            text[i] = value[i];
+
+        firstChanged = dirty ? std::min(firstChanged, difference) : difference;
+        length = newLength;
+        dirty = true;
+    }
+
+    void ProportionalTextLabel::SetNumber(u32 value, u32 minDigits)
+    {
+        std::array<char, maxLength> buffer;
+        Set({ buffer.data(), FormatDecimal(value, buffer.data(), maxLength, minDigits) });
+    }
+
+    void ProportionalTextLabel::CommitVBlank()
+    {
+        if(!dirty)
+            return;
+
+        u32 x = 0;
+        for(u32 i = 0; i < firstChanged; i++)
+            x += font.GetWidth(font.GetGlyphIndex(text[i]));
+
+        //Tiles before the first change keep their pixels, glyphs reaching into firstDirtyTile from the left are drawn again
+        const u32 firstDirtyTile = std::min(x / tileSizePixels.width, tileCount);
+        for(u32 tile = firstDirtyTile; tile < tileCount; tile++)
+            pixels[tile].fill(0);
+
+        x = 0;
+        for(u32 i = 0; i < length; i++)
+        {
+            const u32 glyph = font.GetGlyphIndex(text[i]);
+            if(x + tileSizePixels.width > firstDirtyTile * tileSizePixels.width)
+                DrawGlyph(glyph, x);
+            x += font.GetWidth(glyph);
+        }
+
+        const u32 usedTiles = std::min((x + tileSizePixels.width - 1) / tileSizePixels.width, tileCount);
+        const u32 lastDirtyTile = std::max(usedTiles, drawnTiles);
+        if(lastDirtyTile > firstDirtyTile)
+            FastMemory::Copy32(&block[firstTile + firstDirtyTile], pixels[firstDirtyTile].data(), (lastDirtyTile - firstDirtyTile) * tileWords);
+
+        drawnTiles = usedTiles;
+        dirty = false;
+    }
+
+    void ProportionalTextLabel::DrawGlyph(u32 glyph, u32 x)
+    {
+        const u32 tile = x / tileSizePixels.width;
+        if(tile >= tileCount)
+            return;
+
+        //Four bits per pixel with the leftmost pixel in the lowest nibble, so moving right is a left shift
+        const u32 shift = (x % tileSizePixels.width) * 4;
+        const u32* rows = reinterpret_cast<const u32*>(&font.GetGlyph(glyph));
+        for(u32 y = 0; y < tileSizePixels.height; y++)
+        {
+            pixels[tile][y] |= rows[y] << shift;
+            if(shift != 0 && tile + 1 < tileCount)
+                pixels[tile + 1][y] |= rows[y] >> (32 - shift);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include "TitleScene.hpp"
+#include "SnakeScene.hpp"
+#include "cgba_snake_tiles.hpp"
+#include "cgba_title.hpp"
+#include <iterator>
+
+namespace
+{
+    //3x5 tile letters, '#' is a snake tile
+    constexpr cgba::u32 letterWidth = 3;
+    constexpr cgba::u32 letterHeight = 5;
+    constexpr const char* titleLetters[] = {
+        "###" "#.." "###" "..#" "###",
+        "###" "#.#" "#.#" "#.#" "#.#",
+        "###" "#.#" "###" "#.#" "#.#",
+        "#.#" "#.#" "##." "#.#" "#.#",
+        "###" "#.." "###" "#.." "###"
+    };
+
+    constexpr cgba::u32 letterCount = std::size(titleLetters);
+    constexpr cgba::Point<cgba::i16> titlePosition{ (30 - (letterWidth + 1) * letterCount + 1) / 2, 5 };
+    constexpr cgba::Point<cgba::i16> applePosition{ 14, 13 };
+    constexpr cgba::u32 blinkFrames = 30;
+
+    constexpr cgba::u32 titleLayer = 2;
+}
+
+TitleScene::TitleScene(cgba::SceneContext& _context, cgba::Scene& _game) :
+    cgba::Scene{ _context },
+    game{ _game }
+{
+
+}
+
+void TitleScene::Preload()
+{
+    tiles = AcquireSnakeTiles(context);
+    map = context.vram.AllocateScreenBlocks(cgba::TextScreenSizeMode::W256_H256);
+    CGBA_ASSERT(map.IsValid());
+}
+
+void TitleScene::Enter(cgba::DisplayState& display)
+{
+    SnakeScreenBlockView screen{ context.vram.GetScreenBaseBlock(map) };
+    screen.Fill({ SnakeTiles::empty, false, false, 0 });
+
+    for(cgba::u32 letter = 0; letter < letterCount; letter++)
+    {
+        for(cgba::u32 i = 0; i < letterWidth * letterHeight; i++)
+        {
+            if(titleLetters[letter][i] != '#')
+                continue;
+
+            const cgba::Point<cgba::i16> position{
+                static_cast<cgba::i16>(titlePosition.x + letter * (letterWidth + 1) + i % letterWidth),
+                static_cast<cgba::i16>(titlePosition.y + i / letterWidth) };
+            screen[position].SetTileNumber(SnakeTiles::snake);
+        }
+    }
+    screen[applePosition].SetTileNumber(SnakeTiles::apple);
+
+    context.palette.Load(cgba::graphics::snake_tiles::palette);
+
+    display.control.SetBackgroundMode(cgba::BackgroundMode0::modeValue);
+    SetUpSnakeBackground(display.backgrounds[titleLayer], context.vram.GetScreenBaseBlock(map), 0);
+    for(cgba::u32 layer = 0; layer < cgba::DisplayState::backgroundCount; layer++)
+    {
+        if(layer == titleLayer)
+            display.control.ShowBackground(layer);
+        else
+            display.control.HideBackground(layer);
+    }
+
+    blinking = true;
+    context.tasks.Spawn(BlinkApple());
+    context.music.Play(cgba::music::title::song);
+}
+
+void TitleScene::Exit()
+{
+    blinking = false;
+    context.music.Stop();
+    context.vram.Release(map);
+    context.vram.Release(tiles);
+}
+
+void TitleScene::Update(cgba::SceneManager& scenes)
+{
+    if(context.controller.Pressed(cgba::Key::A) || context.controller.Pressed(cgba::Key::Start))
+        scenes.Replace(game);
+}
+
+cgba::Task TitleScene::BlinkApple()
+{
+    cgba::WordBool visible = true;
+    while(true)
+    {
+        co_await cgba::Frames(blinkFrames);
+
+        //Exit runs before tasks in the VBlank of the switch, so the map is never touched once it's released
+        if(!blinking)
+            co_return;
+
+        visible = !visible;
+        SnakeScreenBlockView{ context.vram.GetScreenBaseBlock(map) }[applePosition].SetTileNumber(visible ? SnakeTiles::apple : SnakeTiles::empty);
+    }
+}
@@ -0,0 +1,239 @@
+#include "VramAllocator.hpp"
+#include "Dma.hpp"
+
+namespace cgba
+{
+    namespace
+    {
+        constexpr u32 UnitsPerTile(PaletteMode mode)
+        {
+            return mode == PaletteMode::Color16_Palette16 ? 1 : 2;
+        }
+    }
+
+    VramAllocator::VramAllocator(WordBool _defragmentOnLoad) :
+        defragmentOnLoad{ _defragmentOnLoad }
+    {
+        Reset();
+    }
+
+    VramHandle VramAllocator::AllocateScreenBlocks(Range<u32, 1, 4> count)
+    {
+        return Allocate({ nullptr, VramRegion::Background, 0, count * screenBlockUnits, 0, backgroundUnits, screenBlockUnits, 1, false }, true);
+    }
+
+    VramHandle VramAllocator::AllocateScreenBlocks(TextScreenSizeMode mode)
+    {
+        switch(mode)
+        {
+        case TextScreenSizeMode::W256_H256:
+            return AllocateScreenBlocks(Area(ScreenSizeConstants<TextScreenSizeMode::W256_H256>::screenSizeBlocks));
+        case TextScreenSizeMode::W512_H256:
+            return AllocateScreenBlocks(Area(ScreenSizeConstants<TextScreenSizeMode::W512_H256>::screenSizeBlocks));
+        case TextScreenSizeMode::W256_H512:
+            return AllocateScreenBlocks(Area(ScreenSizeConstants<TextScreenSizeMode::W256_H512>::screenSizeBlocks));
+        case TextScreenSizeMode::W512_H512:
+            return AllocateScreenBlocks(Area(ScreenSizeConstants<TextScreenSizeMode::W512_H512>::screenSizeBlocks));
+        }
+        return {};
+    }
+
+    VramHandle VramAllocator::AllocateBackgroundTiles(Range<u32, 0, 3> characterBaseBlock, u32 tileCount, PaletteMode mode, const void* key, WordBool relocatable)
+    {
+        if(VramHandle existing = Find(key); existing.IsValid())
+        {
+            Retain(existing);
+            return existing;
+        }
+
+        const u32 windowStart = characterBaseBlock * characterBlockUnits;
+        const u32 addressableEnd = windowStart + 1024 * UnitsPerTile(mode);
+        const u32 windowEnd = addressableEnd < backgroundUnits ? addressableEnd : backgroundUnits;
+        return Allocate({ key, VramRegion::Background, 0, tileCount * UnitsPerTile(mode), windowStart, windowEnd, UnitsPerTile(mode), 1, relocatable }, false);
+    }
+
+    VramHandle VramAllocator::AllocateObjectTiles(u32 tileCount, PaletteMode mode, const void* key, WordBool relocatable, WordBool bitmapMode)
+    {
+        if(VramHandle existing = Find(key); existing.IsValid())
+        {
+            Retain(existing);
+            return existing;
+        }
+
+        const u32 windowStart = bitmapMode ? objectUnits / 2 : 0;
+        return Allocate({ key, VramRegion::Object, 0, tileCount * UnitsPerTile(mode), windowStart, objectUnits, UnitsPerTile(mode), 1, relocatable }, false);
+    }
+
+    void VramAllocator::Retain(VramHandle handle)
+    {
+        CGBA_ASSERT(handle.IsValid() && allocations[handle.index].referenceCount > 0);
+        allocations[handle.index].referenceCount++;
+    }
+
+    void VramAllocator::Release(VramHandle handle)
+    {
+        CGBA_ASSERT(handle.IsValid() && allocations[handle.index].referenceCount > 0);
+        Allocation& allocation = allocations[handle.index];
+        allocation.referenceCount--;
+
+        if(allocation.referenceCount == 0)
+            Mark(allocation.region, allocation.firstUnit, allocation.unitCount, false);
+    }
+
+    VramHandle VramAllocator::Find(const void* key) const
+    {
+        if(!key)
+            return {};
+
+        for(u32 i = 0; i < maxAllocations; i++)
+        {
+            if(allocations[i].referenceCount > 0 && allocations[i].key == key)
+                return { i };
+        }
+        return {};
+    }
+
+    u32 VramAllocator::GetScreenBaseBlock(VramHandle handle) const
+    {
+        return allocations[handle.index].firstUnit / screenBlockUnits;
+    }
+
+    u32 VramAllocator::GetFirstTile(VramHandle handle) const
+    {
+        const Allocation& allocation = allocations[handle.index];
+        const u32 baseUnit = allocation.region == VramRegion::Background ? allocation.windowStart : 0;
+        return (allocation.firstUnit - baseUnit) / (allocation.region == VramRegion::Background ? allocation.alignment : 1);
+    }
+
+    volatile void* VramAllocator::GetAddress(VramHandle handle) const
+    {
+        const Allocation& allocation = allocations[handle.index];
+        return &Memory<volatile u8>(GetRegionAddress(allocation.region) + allocation.firstUnit * unitSize);
+    }
+
+    void VramAllocator::Defragment()
+    {
+        //Walking in address order means every move goes to a lower address, which a forward copy handles even when overlapping
+        u32 lastStart[2] = {};
+        while(true)
+        {
+            u32 next = maxAllocations;
+            for(u32 i = 0; i < maxAllocations; i++)
+            {
+                const Allocation& allocation = allocations[i];
+                if(allocation.referenceCount == 0 || !allocation.relocatable || allocation.firstUnit < lastStart[static_cast<u32>(allocation.region)])
+                    continue;
+                if(next == maxAllocations || allocation.firstUnit < allocations[next].firstUnit)
+                    next = i;
+            }
+
+            if(next == maxAllocations)
+                return;
+
+            Allocation& allocation = allocations[next];
+            lastStart[static_cast<u32>(allocation.region)] = allocation.firstUnit + 1;
+
+            Mark(allocation.region, allocation.firstUnit, allocation.unitCount, false);
+            const u32 target = FindFree(allocation.region, allocation.unitCount, allocation.windowStart, allocation.windowEnd, allocation.alignment, false);
+
+            if(target < allocation.firstUnit)
+            {
+                const uintptr base = GetRegionAddress(allocation.region);
+                Dma::Copy32(&Memory<u32>(base + allocation.firstUnit * unitSize), &Memory<u32>(base + target * unitSize), allocation.unitCount * unitSize / sizeof(u32));
+                allocation.firstUnit = target;
+            }
+
+            Mark(allocation.region, allocation.firstUnit, allocation.unitCount, true);
+        }
+    }
+
+    void VramAllocator::Reset()
+    {
+        allocations = {};
+        backgroundUsage = {};
+        objectUsage = {};
+    }
+
+    VramUsageMap VramAllocator::GetUsageMap() const
+    {
+        VramUsageMap map{};
+        for(u32 unit = 0; unit < backgroundUnits; unit++)
+            map.background[unit / screenBlockUnits] += (backgroundUsage[unit / 32] >> (unit % 32)) & 1;
+
+        for(u32 unit = 0; unit < objectUnits; unit++)
+            map.object[unit / screenBlockUnits] += (objectUsage[unit / 32] >> (unit % 32)) & 1;
+
+        for(const Allocation& allocation : allocations)
+            map.allocationCount += allocation.referenceCount > 0;
+
+        return map;
+    }
+
+    VramHandle VramAllocator::Allocate(const Allocation& allocation, WordBool fromEnd)
+    {
+        u32 slot = maxAllocations;
+        for(u32 i = 0; i < maxAllocations && slot == maxAllocations; i++)
+        {
+            if(allocations[i].referenceCount == 0)
+                slot = i;
+        }
+
+        if(slot == maxAllocations || allocation.unitCount == 0)
+            return {};
+
+        u32 firstUnit = FindFree(allocation.region, allocation.unitCount, allocation.windowStart, allocation.windowEnd, allocation.alignment, fromEnd);
+        if(firstUnit == VramHandle::invalidIndex && defragmentOnLoad)
+        {
+            Defragment();
+            firstUnit = FindFree(allocation.region, allocation.unitCount, allocation.windowStart, allocation.windowEnd, allocation.alignment, fromEnd);
+        }
+
+        if(firstUnit == VramHandle::invalidIndex)
+            return {};
+
+        allocations[slot] = allocation;
+        allocations[slot].firstUnit = firstUnit;
+        Mark(allocation.region, firstUnit, allocation.unitCount, true);
+        return { slot };
+    }
+
+    u32 VramAllocator::FindFree(VramRegion region, u32 unitCount, u32 windowStart, u32 windowEnd, u32 alignment, WordBool fromEnd) const
+    {
+        if(windowEnd - windowStart < unitCount)
+            return VramHandle::invalidIndex;
+
+        const u32 last = windowStart + (windowEnd - windowStart - unitCount) / alignment * alignment;
+        const u32 candidates = (last - windowStart) / alignment + 1;
+
+        for(u32 i = 0; i < candidates; i++)
+        {
+            const u32 firstUnit = fromEnd ? last - i * alignment : windowStart + i * alignment;
+            if(IsFree(region, firstUnit, unitCount))
+                return firstUnit;
+        }
+        return VramHandle::invalidIndex;
+    }
+
+    WordBool VramAllocator::IsFree(VramRegion region, u32 firstUnit, u32 unitCount) const
+    {
+        const u32* usage = GetUsage(region);
+        for(u32 unit = firstUnit; unit < firstUnit + unitCount; unit++)
+        {
+            if((usage[unit / 32] >> (unit % 32)) & 1)
+                return false;
+        }
+        return true;
+    }
+
+    void VramAllocator::Mark(VramRegion region, u32 firstUnit, u32 unitCount, WordBool used)
+    {
+        u32* usage = GetUsage(region);
+        for(u32 unit = firstUnit; unit < firstUnit + unitCount; unit++)
+        {
+            if(used)
+                usage[unit / 32] |= 1u << (unit % 32);
+            else
+                usage[unit / 32] &= ~(1u << (unit % 32));
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#include "Window.hpp"
+#include "Dma.hpp"
+#include <algorithm>
+
+namespace cgba
+{
+    namespace
+    {
+        u32 SquareRoot(u32 value)
+        {
+            u32 root = 0;
+            for(u32 bit = 1u << 15; bit > 0; bit >>= 1)
+            {
+                const u32 candidate = root | bit;
+                if(candidate * candidate <= value)
+                    root = candidate;
+            }
+            return root;
+        }
+    }
+
+    ShapedWindow::ShapedWindow(Range<u32, 0, 1> _window, Range<u32, 0, 2> _dmaChannel) :
+        window{ _window },
+        dmaChannel{ _dmaChannel }
+    {
+
+    }
+
+    void ShapedWindow::SetSpan(Range<u32, 0, lineCount - 1> line, i32 left, i32 right)
+    {
+        constexpr i32 screenWidth = Display::hardwareScreenSizePixels.width;
+        left = std::clamp(left, 0, screenWidth);
+        right = std::clamp(right, 0, screenWidth);
+
+        //Hardware treats a start past the end as reaching the screen edge, so empty lines use an empty span at 0 instead
+        spans[line] = (left < right) ? WindowBoundsRegister{ static_cast<u32>(left), static_cast<u32>(right) }.data : 0;
+        if(line == lineCount - 1)
+            spans[lineCount] = spans[line];
+    }
+
+    void ShapedWindow::Clear()
+    {
+        spans.fill(0);
+    }
+
+    void ShapedWindow::SetCircle(Point<i16> center, u32 radius)
+    {
+        for(u32 y = 0; y < lineCount; y++)
+        {
+            const i32 distance = static_cast<i32>(y) - center.y;
+            const u32 distanceSquared = static_cast<u32>(distance * distance);
+            if(distanceSquared > radius * radius)
+            {
+                SetSpan(y, 0, 0);
+                continue;
+            }
+
+            const i32 halfWidth = static_cast<i32>(SquareRoot(radius * radius - distanceSquared));
+            SetSpan(y, center.x - halfWidth, center.x + halfWidth + 1);
+        }
+    }
+
+    void ShapedWindow::SetDiagonalWipe(i32 edge)
+    {
+        for(u32 y = 0; y < lineCount; y++)
+            SetSpan(y, 0, edge - static_cast<i32>(y));
+    }
+
+    void ShapedWindow::CommitVBlank()
+    {
+        Window::GetHorizontalRegister(window) = spans[0];
+        Window::GetVerticalRegister(window) = WindowBoundsRegister{ 0, lineCount }.data;
+
+        DmaControlRegister control{};
+        control.SetDestinationAddressControl(DmaAddressControl::Fixed);
+        control.SetSourceAddressControl(DmaAddressControl::Increment);
+        control.SetTransferType(DmaTransferType::Bits16);
+        control.SetStartTiming(DmaStartTiming::HBlank);
+        control.EnableRepeat();
+
+        //Restarting every VBlank rewinds the source to line 1
+        Dma::Start(dmaChannel, &spans[1], &Window::GetHorizontalRegister(window), 1, control);
+    }
+
+    void ShapedWindow::Stop()
+    {
+        Dma::Stop(dmaChannel);
+    }
+}
@@ -1,25 +1,60 @@
 #include "bn_core.h"
 #include "Display.hpp"
 #include "Input.hpp"
+#include "Arena.hpp"
+#include "SceneManager.hpp"
 #include "SnakeScene.hpp"
+#include "TitleScene.hpp"
 #include <bn_random.h>
 
 bn::random defaultRandomGenerator;
 
+namespace
+{
+    //Large enough for any compressed asset a scene preloads
+    constexpr cgba::u32 stagingBufferSize = 8 * 1024;
+
+    //About 32 scanlines of decompression per frame, leaving the rest of the frame to the scene
+    constexpr cgba::u32 loaderCycleBudget = 32 * 1232;
+
+    //Everything main takes from the EWRAM arena, with room for alignment, so the allocations can't fail
+    static_assert(stagingBufferSize + sizeof(cgba::PaletteEngine) + sizeof(cgba::DirectSound) + 16 <= cgba::MemoryArenas::ewramArenaSize);
+}
+
 int main()
 {
-    //For now use bncore to get access to the assert
+    //bn::core::init still sets up interrupts and the rest of the runtime
     bn::core::init();
     //Clear DisplayControlStatus for now as bn::core::init enables some of the stuff
     //making SetBackgroundMode not work as intended, without bn::core::init, force blank flag is enabled by default for some reason
-    cgba::Display::GetControlRegister().HideObjectWindow();
-    cgba::Display::GetControlRegister().HideWindow0();
-    cgba::Display::GetControlRegister().HideWindow1();
-
-    while(1)
+    cgba::DisplayControl::Modify([](cgba::DisplayControlRegister& control)
     {
-        SnakeScene();
-    }
+        control.HideObjectWindow();
+        control.HideWindow0();
+        control.HideWindow1();
+    });
+
+    cgba::Arena& ewram = cgba::MemoryArenas::Ewram();
+    cgba::u16* stagingBuffer = static_cast<cgba::u16*>(ewram.Allocate(stagingBufferSize));
+    CGBA_ASSERT(stagingBuffer);
+
+    cgba::VramAllocator vramAllocator;
+    cgba::AssetLoader assetLoader{ stagingBuffer, stagingBufferSize, loaderCycleBudget };
+    cgba::PaletteEngine* palette = ewram.New<cgba::PaletteEngine>();
+    cgba::FramePipeline pipeline;
+    cgba::InputLatch inputLatch;
+    cgba::BasicController controller;
+    cgba::TaskScheduler tasks;
+    cgba::DirectSound* sound = ewram.New<cgba::DirectSound>();
+    CGBA_ASSERT(palette && sound);
+    sound->Start();
+    cgba::PsgPlayer music;
+    cgba::SceneContext context{ vramAllocator, assetLoader, *palette, pipeline, inputLatch, controller, tasks, *sound, music };
+
+    GameOverScene gameOverScene{ context };
+    SnakeScene snakeScene{ context, gameOverScene };
+    TitleScene titleScene{ context, snakeScene };
 
-    return 0;
+    cgba::SceneManager scenes{ context };
+    scenes.Run(titleScene);
 }
@@ -0,0 +1,280 @@
+"""
+Host side compressor producing the GBA BIOS LZ77, run length and huffman formats read by cgba::Decompressor.
+
+Every stream starts with a 32 bit header: bits 4 to 7 hold the type, bits 8 to 31 the decompressed size and,
+for huffman, bits 0 to 3 the size of a symbol. Streams are padded to a multiple of 4 bytes.
+
+Usage: compressor.py lz77|rle|huffman4|huffman8 <input> <output>
+"""
+
+import heapq
+import struct
+import sys
+
+LZ77_TYPE = 1
+HUFFMAN_TYPE = 2
+RUN_LENGTH_TYPE = 3
+
+
+def header(compression_type, size, unit_size=0):
+    if size >= 1 << 24:
+        raise ValueError('data must be smaller than 16MB')
+
+    return struct.pack('<I', (size << 8) | (compression_type << 4) | unit_size)
+
+
+def pad(data):
+    return data + bytes(-len(data) % 4)
+
+
+# The BIOS VRAM variant writes halfwords, so a match one byte back would read a byte that isn't written yet.
+# vram_safe keeps every match at least 2 bytes back to stay compatible with it
+def compress_lz77(data, vram_safe=True):
+    min_distance = 2 if vram_safe else 1
+    max_distance = 4096
+    min_length = 3
+    max_length = 18
+    max_candidates = 256
+
+    output = bytearray(header(LZ77_TYPE, len(data)))
+    positions = {}
+    position = 0
+
+    def remember(index):
+        if index + min_length <= len(data):
+            positions.setdefault(bytes(data[index:index + min_length]), []).append(index)
+
+    while position < len(data):
+        flags_index = len(output)
+        output.append(0)
+
+        for block in range(8):
+            if position >= len(data):
+                break
+
+            best_length = 0
+            best_distance = 0
+            for candidate in reversed(positions.get(bytes(data[position:position + min_length]), [])[-max_candidates:]):
+                distance = position - candidate
+                if distance > max_distance:
+                    break
+                if distance < min_distance:
+                    continue
+
+                length = 0
+                while length < max_length and position + length < len(data) and \
+                        data[candidate + length] == data[position + length]:
+                    length += 1
+
+                if length > best_length:
+                    best_length = length
+                    best_distance = distance
+                    if length == max_length:
+                        break
+
+            if best_length >= min_length:
+                output[flags_index] |= 0x80 >> block
+                output.append(((best_length - 3) << 4) | ((best_distance - 1) >> 8))
+                output.append((best_distance - 1) & 0xFF)
+                for index in range(position, position + best_length):
+                    remember(index)
+                position += best_length
+            else:
+                output.append(data[position])
+                remember(position)
+                position += 1
+
+    return pad(bytes(output))
+
+
+def compress_run_length(data):
+    output = bytearray(header(RUN_LENGTH_TYPE, len(data)))
+    position = 0
+    raw = bytearray()
+
+    def flush_raw():
+        while raw:
+            chunk = raw[:128]
+            output.append(len(chunk) - 1)
+            output.extend(chunk)
+            del raw[:128]
+
+    while position < len(data):
+        run = 1
+        while run < 130 and position + run < len(data) and data[position + run] == data[position]:
+            run += 1
+
+        if run >= 3:
+            flush_raw()
+            output.append(0x80 | (run - 3))
+            output.append(data[position])
+            position += run
+        else:
+            raw.append(data[position])
+            position += 1
+
+    flush_raw()
+    return pad(bytes(output))
+
+
+def compress_huffman(data, unit_size):
+    if unit_size == 8:
+        units = list(data)
+    else:
+        units = [unit for byte in data for unit in (byte & 0xF, byte >> 4)]
+
+    frequencies = {}
+    for unit in units:
+        frequencies[unit] = frequencies.get(unit, 0) + 1
+
+    # A tree needs at least two leaves
+    if len(frequencies) < 2:
+        frequencies[(units[0] + 1) % (1 << unit_size) if units else 0] = 0
+
+    # Nodes are either ('leaf', value) or ('node', left, right)
+    heap = [(count, value, ('leaf', value)) for value, count in frequencies.items()]
+    heapq.heapify(heap)
+    order = 1 << unit_size
+    while len(heap) > 1:
+        count0, _, node0 = heapq.heappop(heap)
+        count1, _, node1 = heapq.heappop(heap)
+        heapq.heappush(heap, (count0 + count1, order, ('node', node0, node1)))
+        order += 1
+
+    root = heap[0][2]
+
+    codes = {}
+
+    def assign(node, code):
+        if node[0] == 'leaf':
+            codes[node[1]] = code
+        else:
+            assign(node[1], code + '0')
+            assign(node[2], code + '1')
+
+    assign(root, '')
+
+    # Children of a node sit as a pair at most 63 pairs after the pair holding the node.
+    # Breadth first suits balanced trees, depth first with the smaller subtree first suits skewed ones
+    def layout(breadth_first):
+        pairs = []
+        table = {}
+        pending = [(root, -1)]
+
+        while pending:
+            node, pair_index = pending.pop(0) if breadth_first else pending.pop()
+            children_pair = len(pairs)
+            pairs.append((node[1], node[2]))
+            offset = children_pair - pair_index - 1
+            if offset > 63:
+                return None
+
+            flags = (0x80 if node[1][0] == 'leaf' else 0) | (0x40 if node[2][0] == 'leaf' else 0)
+            table[id(node)] = flags | offset
+
+            children = [child for child in (node[1], node[2]) if child[0] == 'node']
+            if not breadth_first:
+                children.sort(key=leaf_count, reverse=True)
+            pending.extend((child, children_pair) for child in children)
+
+        return pairs, table
+
+    def leaf_count(node):
+        return 1 if node[0] == 'leaf' else leaf_count(node[1]) + leaf_count(node[2])
+
+    result = layout(True) or layout(False)
+    if result is None:
+        raise ValueError('huffman tree can\'t be laid out in the BIOS format, try 4 bit symbols')
+
+    pairs, table = result
+    tree = bytearray([table[id(root)]])
+    for left, right in pairs:
+        for child in (left, right):
+            tree.append(child[1] if child[0] == 'leaf' else table[id(child)])
+
+    # The size byte counts the whole table, itself included, in halfwords minus one.
+    # The bitstream is read from right after the table, so the table is padded to keep it 32 bit aligned
+    while (1 + len(tree)) % 4 != 0:
+        tree.append(0)
+    tree_size = (1 + len(tree)) // 2 - 1
+    if tree_size > 0xFF:
+        raise ValueError('huffman tree too large')
+
+    output = bytearray(header(HUFFMAN_TYPE, len(data), unit_size))
+    output.append(tree_size)
+    output.extend(tree)
+
+    # Codes are read from the most significant bit of little endian 32 bit words
+    word = 0
+    word_bits = 0
+    for unit in units:
+        for bit in codes[unit]:
+            word = (word << 1) | int(bit)
+            word_bits += 1
+            if word_bits == 32:
+                output.extend(struct.pack('<I', word))
+                word = 0
+                word_bits = 0
+
+    if word_bits:
+        output.extend(struct.pack('<I', word << (32 - word_bits)))
+
+    return bytes(output)
+
+
+# Decodes the way the BIOS does, to check compress_huffman against it
+def decompress_huffman(compressed):
+    size = struct.unpack_from('<I', compressed)[0]
+    unit_size = size & 0xF
+    size >>= 8
+    tree = 4
+    bitstream = tree + (compressed[tree] + 1) * 2
+
+    units = []
+    node = tree + 1
+    while len(units) * unit_size < size * 8:
+        word = struct.unpack_from('<I', compressed, bitstream)[0]
+        bitstream += 4
+        for bit in range(31, -1, -1):
+            child = (node & ~1) + (compressed[node] & 0x3F) * 2 + 2 + ((word >> bit) & 1)
+            if compressed[node] & (0x80 >> ((word >> bit) & 1)):
+                units.append(compressed[child])
+                node = tree + 1
+                if len(units) * unit_size >= size * 8:
+                    break
+            else:
+                node = child
+
+    if unit_size == 8:
+        return bytes(units)
+    return bytes(units[i] | (units[i + 1] << 4) for i in range(0, len(units), 2))
+
+
+def compress(data, method):
+    if method == 'lz77':
+        return compress_lz77(data)
+    if method == 'rle':
+        return compress_run_length(data)
+    if method not in ('huffman4', 'huffman8'):
+        raise ValueError('unknown compression ' + method)
+
+    compressed = compress_huffman(data, 4 if method == 'huffman4' else 8)
+    if decompress_huffman(compressed) != bytes(data):
+        raise ValueError(method + ' output doesn\'t decode back to its input')
+    return compressed
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 4:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[2], 'rb') as input_file:
+        try:
+            compressed = compress(input_file.read(), sys.argv[1])
+        except ValueError as error:
+            sys.stderr.write('compressor error: ' + str(error) + '\n')
+            sys.exit(1)
+
+    with open(sys.argv[3], 'wb') as output_file:
+        output_file.write(compressed)
@@ -0,0 +1,56 @@
+//Times the software mixer natively, to compare the cost of each extra channel and of changes to the mixing loops.
+//The mixer has no hardware dependencies, build from the project directory with:
+//  g++ -std=c++20 -O2 -DNDEBUG -Iinclude tools/mixer_benchmark.cpp src/Mixer.cpp src/Mixer.bn_iwram.cpp -o mixer_benchmark
+//Numbers are host nanoseconds, only the ratios between them carry over to the GBA
+#include "Mixer.hpp"
+#include "DirectSound.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    constexpr cgba::DirectSoundRate rate = cgba::DirectSoundRate::Hz18157;
+    constexpr cgba::u32 samplesPerFrame = cgba::DirectSound::GetSamplesPerFrame(rate);
+    constexpr cgba::u32 frames = 20000;
+
+    std::array<cgba::i8, 4096> MakeSampleData()
+    {
+        std::array<cgba::i8, 4096> data{};
+        cgba::u32 noise = 0x1234'5678;
+        for(cgba::i8& value : data)
+        {
+            noise = noise * 1664525 + 1013904223;
+            value = static_cast<cgba::i8>(noise >> 24);
+        }
+        return data;
+    }
+}
+
+int main()
+{
+    static const std::array<cgba::i8, 4096> sampleData = MakeSampleData();
+    const cgba::SoundSample sample{ sampleData.data(), sampleData.size(), 22050, 0 };
+    std::array<cgba::i8, samplesPerFrame> output{};
+
+    std::printf("channels  ns/frame  ns/sample/channel\n");
+    for(cgba::u32 channels = 0; channels <= cgba::Mixer::maxChannels; channels++)
+    {
+        cgba::Mixer mixer{ cgba::DirectSound::GetSampleRate(rate) };
+        for(cgba::u32 i = 0; i < channels; i++)
+            mixer.Play(sample, cgba::Mixer::maxVolume / 2, 11025 + i * 3000);
+
+        cgba::i32 checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for(cgba::u32 frame = 0; frame < frames; frame++)
+        {
+            mixer.Mix(output.data(), output.size());
+            checksum += output[frame % output.size()];
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        const double perFrame = elapsed / frames;
+        const double perSample = channels > 0 ? perFrame / (samplesPerFrame * channels) : 0.0;
+        std::printf("%8u  %8.0f  %17.3f  (%d)\n", channels, perFrame, perSample, checksum);
+    }
+}
@@ -0,0 +1,259 @@
+"""
+Converts 4 channel ProTracker MOD files into cgba::PsgSong data for the PSG channels.
+
+Every <name>.mod in the audio folder produces <build>/cgba_<name>.hpp. MOD channels 1 to 4 play on the two square channels,
+the wave channel and the noise channel. Only notes, instruments, note cuts by C00, the first Fxx speed and Dxx pattern breaks
+are converted, other effects are ignored. An optional <name>.json next to the module describes the instruments:
+    "instruments": list indexed by MOD sample number - 1, each an object with
+        "duty": 0 to 3, square duty of 12.5%, 25%, 50% or 75%, defaults to 2
+        "volume": envelope start volume 0 to 15, defaults to 15
+        "envelope_step": 0 to 7, 0 keeps the volume, defaults to 0
+        "envelope_up": whether the envelope rises instead of falling, defaults to false
+        "sweep": raw SOUND1CNT_L value for channel 1, defaults to 0
+        "wave": index into "waves" for the wave channel, defaults to 0
+        "wave_volume": 1 full, 2 half, 3 quarter, 4 three quarters, defaults to 1
+        "short_noise": whether the noise channel uses the 7 bit counter, defaults to false
+    "waves": list of waves of 32 samples from 0 to 15, defaults to a single triangle
+    "transpose": semitones added to every note, MOD C-1 is C3 without it
+    "speed": ticks per row, overriding the module's
+"""
+
+import argparse
+import json
+import math
+import os
+import struct
+import sys
+
+ROWS_PER_PATTERN = 64
+CHANNEL_COUNT = 4
+NOTE_COUNT = 72
+NOTE_OFF = 0x7F
+INSTRUMENT_FOLLOWS = 0x80
+MAX_NOISE = 0x6F
+DEFAULT_SPEED = 6
+
+TRIANGLE = [min(i, 31 - i) for i in range(32)]
+
+
+class Module:
+    def __init__(self, file_path):
+        with open(file_path, 'rb') as file:
+            data = file.read()
+
+        if len(data) < 1084 or data[1080:1084] not in (b'M.K.', b'M!K!', b'4CHN', b'FLT4'):
+            raise ValueError(file_path + ' is not a 4 channel MOD file')
+
+        song_length = data[950]
+        self.order = list(data[952:952 + song_length])
+        self.restart = data[951] if data[951] < song_length else 0
+        pattern_count = max(data[952:952 + 128]) + 1
+
+        self.patterns = []
+        for pattern in range(pattern_count):
+            rows = []
+            for row in range(ROWS_PER_PATTERN):
+                cells = []
+                for channel in range(CHANNEL_COUNT):
+                    offset = 1084 + ((pattern * ROWS_PER_PATTERN + row) * CHANNEL_COUNT + channel) * 4
+                    if offset + 4 > len(data):
+                        raise ValueError(file_path + ' is truncated')
+
+                    b0, b1, b2, b3 = struct.unpack_from('BBBB', data, offset)
+                    cells.append(((b0 & 0xF0) | (b2 >> 4), ((b0 & 0x0F) << 8) | b1, b2 & 0x0F, b3))
+                rows.append(cells)
+            self.patterns.append(rows)
+
+
+def period_to_note(period):
+    # Period 856 is C-1 and every octave up halves it
+    return int(round(12 * math.log2(856 / period)))
+
+
+def noise_note(note):
+    # Higher notes get a higher pitched noise, which has a lower shift and divider
+    return MAX_NOISE - min(max(note, 0), NOTE_COUNT - 1) * MAX_NOISE // (NOTE_COUNT - 1)
+
+
+def encode_instrument(settings):
+    envelope = (settings.get('duty', 2) << 6) | (settings.get('envelope_step', 0) << 8) | \
+               (int(settings.get('envelope_up', False)) << 11) | (settings.get('volume', 15) << 12)
+    sweep = settings.get('sweep', 0) | (0x8 if settings.get('short_noise', False) else 0)
+    # The wave volume is the SOUND3CNT_H volume code, with the forced 75% volume in its top bit
+    wave_volume = settings.get('wave_volume', 1)
+    if wave_volume < 1 or wave_volume > 4:
+        raise ValueError('wave_volume goes from 1 to 4')
+
+    wave = settings.get('wave', 0) | (wave_volume << 5)
+    return envelope, sweep, wave
+
+
+def encode_wave(samples):
+    if len(samples) != 32 or any(sample < 0 or sample > 15 for sample in samples):
+        raise ValueError('waves need 32 samples from 0 to 15')
+
+    packed = bytes((samples[i] << 4) | samples[i + 1] for i in range(0, 32, 2))
+    return struct.unpack('<4I', packed)
+
+
+def encode_pattern(name, rows, transpose):
+    data = []
+    instruments = [None] * CHANNEL_COUNT
+    row_count = 0
+
+    for cells in rows:
+        mask = 0
+        row_data = []
+        pattern_break = False
+
+        for channel, (sample, period, effect, parameter) in enumerate(cells):
+            if effect == 0xD:
+                pattern_break = True
+
+            if effect == 0xC and parameter == 0:
+                note = NOTE_OFF
+            elif period != 0:
+                note = period_to_note(period) + 12 + transpose
+                if channel == 3:
+                    note = noise_note(note)
+                elif note < 0 or note >= NOTE_COUNT:
+                    raise ValueError(name + ': note out of the C2 to B7 range')
+            else:
+                continue
+
+            mask |= 1 << channel
+            if sample != 0 and note != NOTE_OFF and instruments[channel] != sample:
+                instruments[channel] = sample
+                row_data += [note | INSTRUMENT_FOLLOWS, sample - 1]
+            else:
+                row_data.append(note)
+
+        data += [mask] + row_data
+        row_count += 1
+        if pattern_break:
+            break
+
+    return [row_count] + data
+
+
+def find_speed(module):
+    for row in module.patterns[module.order[0]]:
+        for _, _, effect, parameter in row:
+            if effect == 0xF and 0 < parameter < 32:
+                return parameter
+    return DEFAULT_SPEED
+
+
+def format_bytes(values, indent):
+    return [indent + ' '.join(hex(value) + ',' for value in values[index:index + 16]) for index in range(0, len(values), 16)]
+
+
+def write_header(name, module, settings, header_path):
+    transpose = settings.get('transpose', 0)
+    speed = settings.get('speed', find_speed(module))
+    used = sorted(set(module.order))
+    pattern_index = {pattern: index for index, pattern in enumerate(used)}
+
+    instrument_count = max([cell[0] for pattern in used for row in module.patterns[pattern] for cell in row] + [1])
+    instrument_settings = settings.get('instruments', [])
+    instruments = [encode_instrument(instrument_settings[i] if i < len(instrument_settings) else {}) for i in range(instrument_count)]
+    waves = [encode_wave(wave) for wave in settings.get('waves', [TRIANGLE])]
+
+    if any(wave & 0x1F >= len(waves) for _, _, wave in instruments):
+        raise ValueError(name + ': an instrument uses a wave that isn\'t in "waves"')
+
+    lines = [
+        '//Generated by tools/psg_converter.py from ' + name + '.mod, do not edit',
+        '#pragma once',
+        '#include "PsgPlayer.hpp"',
+        '',
+        'namespace cgba::music::' + name,
+        '{',
+    ]
+
+    total = 0
+    for pattern in used:
+        data = encode_pattern(name, module.patterns[pattern], transpose)
+        total += len(data)
+        lines.append('    constexpr std::array<u8, ' + str(len(data)) + '> pattern' + str(pattern_index[pattern]) + ' =')
+        lines.append('    {')
+        lines += format_bytes(data, '        ')
+        lines += ['    };', '']
+
+    lines.append('    constexpr std::array<const u8*, ' + str(len(used)) + '> patterns =')
+    lines.append('    {')
+    lines.append('        ' + ' '.join('pattern' + str(index) + '.data(),' for index in range(len(used))))
+    lines += ['    };', '']
+
+    order = [pattern_index[pattern] for pattern in module.order]
+    lines.append('    constexpr std::array<u8, ' + str(len(order)) + '> order =')
+    lines.append('    {')
+    lines += format_bytes(order, '        ')
+    lines += ['    };', '']
+
+    lines.append('    constexpr std::array<PsgInstrument, ' + str(len(instruments)) + '> instruments =')
+    lines.append('    {')
+    for envelope, sweep, wave in instruments:
+        lines.append('        PsgInstrument{ ' + hex(envelope) + ', ' + hex(sweep) + ', ' + hex(wave) + ' },')
+    lines += ['    };', '']
+
+    lines.append('    alignas(4) constexpr std::array<PsgWave, ' + str(len(waves)) + '> waves =')
+    lines.append('    {')
+    for wave in waves:
+        lines.append('        PsgWave{ ' + ', '.join(hex(word) for word in wave) + ' },')
+    lines += ['    };', '']
+
+    lines += [
+        '    constexpr PsgSong song{ patterns.data(), order.data(), ' + str(len(order)) + ', ' + str(module.restart) + ', ' +
+        str(speed) + ', instruments.data(), ' + str(len(instruments)) + ', waves.data(), ' + str(len(waves)) + ' };',
+        '}',
+        '',
+    ]
+
+    with open(header_path, 'w') as file:
+        file.write('\n'.join(lines))
+
+    return len(used), total
+
+
+def process(audio_path, build_path):
+    if not os.path.isdir(audio_path):
+        return
+
+    os.makedirs(build_path, exist_ok=True)
+
+    for file_name in sorted(os.listdir(audio_path)):
+        name, extension = os.path.splitext(file_name)
+        if extension.lower() != '.mod':
+            continue
+
+        mod_path = os.path.join(audio_path, file_name)
+        json_path = os.path.join(audio_path, name + '.json')
+        header_path = os.path.join(build_path, 'cgba_' + name + '.hpp')
+        inputs = [mod_path, __file__] + ([json_path] if os.path.isfile(json_path) else [])
+
+        if os.path.isfile(header_path) and \
+                os.path.getmtime(header_path) >= max(os.path.getmtime(path) for path in inputs):
+            continue
+
+        settings = {}
+        if os.path.isfile(json_path):
+            with open(json_path) as file:
+                settings = json.load(file)
+
+        pattern_count, pattern_bytes = write_header(name, Module(mod_path), settings, header_path)
+        print(file_name + ': ' + str(pattern_count) + ' patterns in ' + str(pattern_bytes) + ' bytes')
+
+
+if __name__ == '__main__':
+    project_path = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description='cgba PSG music converter')
+    parser.add_argument('--audio', default='dmg_audio/cgba', help='folder containing the MOD files')
+    parser.add_argument('--build', default='build', help='folder where the generated headers are written')
+    args = parser.parse_args()
+
+    try:
+        process(os.path.join(project_path, args.audio), os.path.join(project_path, args.build))
+    except ValueError as error:
+        sys.stderr.write('psg_converter error: ' + str(error) + '\n')
+        sys.exit(1)
@@ -0,0 +1,265 @@
+"""
+Converts indexed BMP files into cgba character tiles, palettes and text background maps.
+
+Every <name>.bmp in the graphics folder produces <build>/cgba_<name>.hpp. An optional <name>.json next to the
+image can override the defaults:
+    "bpp": 4 or 8, defaults to 4 when the image palette has at most 16 colors
+    "palette_number": palette written into the map entries of 4bpp images, defaults to 0
+    "map": whether to emit a tile map for the image, defaults to true
+    "deduplicate": whether to merge identical and flipped tiles, defaults to true
+    "compression": "lz77", "rle", "huffman4" or "huffman8" to also emit compressedTiles for cgba::Decompress
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+import compressor
+
+TILE_SIZE = 8
+
+
+class Bitmap:
+    def __init__(self, file_path):
+        with open(file_path, 'rb') as file:
+            data = file.read()
+
+        if data[0:2] != b'BM':
+            raise ValueError(file_path + ' is not a BMP file')
+
+        pixels_offset = struct.unpack_from('<I', data, 10)[0]
+        header_size, width, height, planes, bpp, compression = struct.unpack_from('<IiiHHI', data, 14)
+        colors_used = struct.unpack_from('<I', data, 46)[0]
+
+        if bpp not in (4, 8):
+            raise ValueError(file_path + ' must be a 4bpp or 8bpp indexed BMP (found ' + str(bpp) + 'bpp)')
+
+        if compression != 0:
+            raise ValueError(file_path + ' must not be compressed')
+
+        top_down = height < 0
+        height = abs(height)
+
+        if width % TILE_SIZE != 0 or height % TILE_SIZE != 0:
+            raise ValueError(file_path + ' size must be a multiple of ' + str(TILE_SIZE) + ' pixels')
+
+        if colors_used == 0:
+            colors_used = 1 << bpp
+
+        palette_offset = 14 + header_size
+        self.palette = []
+        for index in range(colors_used):
+            blue, green, red, _ = struct.unpack_from('<BBBB', data, palette_offset + index * 4)
+            self.palette.append((red >> 3) | ((green >> 3) << 5) | ((blue >> 3) << 10))
+
+        row_size = ((width * bpp + 31) // 32) * 4
+        self.width = width
+        self.height = height
+        self.pixels = []
+
+        for y in range(height):
+            source_row = y if top_down else height - 1 - y
+            row_data = data[pixels_offset + source_row * row_size:pixels_offset + (source_row + 1) * row_size]
+            row = []
+
+            for x in range(width):
+                if bpp == 8:
+                    row.append(row_data[x])
+                else:
+                    byte = row_data[x // 2]
+                    row.append(byte >> 4 if x % 2 == 0 else byte & 0xF)
+
+            self.pixels.append(row)
+
+    def tile(self, tile_x, tile_y):
+        return tuple(self.pixels[tile_y * TILE_SIZE + y][tile_x * TILE_SIZE + x]
+                     for y in range(TILE_SIZE) for x in range(TILE_SIZE))
+
+
+def flip_horizontal(tile):
+    return tuple(tile[y * TILE_SIZE + (TILE_SIZE - 1 - x)] for y in range(TILE_SIZE) for x in range(TILE_SIZE))
+
+
+def flip_vertical(tile):
+    return tuple(tile[(TILE_SIZE - 1 - y) * TILE_SIZE + x] for y in range(TILE_SIZE) for x in range(TILE_SIZE))
+
+
+class TileSet:
+    def __init__(self, deduplicate):
+        self.deduplicate = deduplicate
+        self.tiles = []
+        self.lookup = {}
+
+    # Returns (tile number, flip horizontal, flip vertical) describing how to draw the tile from the unique set
+    def add(self, tile):
+        if self.deduplicate and tile in self.lookup:
+            return self.lookup[tile]
+
+        tile_number = len(self.tiles)
+        self.tiles.append(tile)
+
+        if self.deduplicate:
+            horizontal = flip_horizontal(tile)
+            vertical = flip_vertical(tile)
+            both = flip_vertical(horizontal)
+
+            # Register the unflipped variant last so it wins when the tile is symmetric
+            self.lookup.setdefault(both, (tile_number, True, True))
+            self.lookup.setdefault(vertical, (tile_number, False, True))
+            self.lookup.setdefault(horizontal, (tile_number, True, False))
+            self.lookup[tile] = (tile_number, False, False)
+
+        return self.lookup.get(tile, (tile_number, False, False))
+
+
+def format_tile(tile):
+    rows = []
+    for row in range(TILE_SIZE):
+        rows.append(', '.join(str(value) for value in tile[row * TILE_SIZE:(row + 1) * TILE_SIZE]))
+
+    return ',\n            '.join(rows)
+
+
+def tile_bytes(tiles, bpp):
+    if bpp == 8:
+        return bytes(pixel for tile in tiles for pixel in tile)
+
+    return bytes(tile[i] | (tile[i + 1] << 4) for tile in tiles for i in range(0, len(tile), 2))
+
+
+def write_header(name, bitmap, settings, header_path):
+    bpp = settings.get('bpp', 4 if len(bitmap.palette) <= 16 else 8)
+    palette_number = settings.get('palette_number', 0)
+    emit_map = settings.get('map', True)
+    tile_set = TileSet(settings.get('deduplicate', True))
+
+    if bpp not in (4, 8):
+        raise ValueError(name + ': bpp must be 4 or 8')
+
+    if bpp == 4 and max(max(row) for row in bitmap.pixels) > 15:
+        raise ValueError(name + ': 4bpp images can only use the first 16 palette colors')
+
+    tiles_size = (bitmap.width // TILE_SIZE, bitmap.height // TILE_SIZE)
+    map_entries = []
+    for tile_y in range(tiles_size[1]):
+        for tile_x in range(tiles_size[0]):
+            map_entries.append(tile_set.add(bitmap.tile(tile_x, tile_y)))
+
+    if len(tile_set.tiles) > 1024:
+        raise ValueError(name + ': ' + str(len(tile_set.tiles)) + ' unique tiles, text backgrounds can address 1024')
+
+    palette = bitmap.palette[:16 if bpp == 4 else 256]
+    palette_size = len(palette)
+    tile_type = 'CharacterTile16' if bpp == 4 else 'CharacterTile256'
+    palette_mode = 'Color16_Palette16' if bpp == 4 else 'Color256_Palette1'
+
+    lines = [
+        '//Generated by tools/tile_converter.py from ' + name + '.bmp, do not edit',
+        '#pragma once',
+        '#include "VRAMFormats.hpp"',
+        '',
+        'namespace cgba::graphics::' + name,
+        '{',
+        '    constexpr PaletteMode paletteMode = PaletteMode::' + palette_mode + ';',
+        '',
+        '    alignas(4) constexpr std::array<RGB15, ' + str(palette_size) + '> palette =',
+        '    {',
+    ]
+
+    for index in range(0, palette_size, 8):
+        lines.append('        ' + ' '.join('RGB15{ ' + hex(color) + ' },' for color in palette[index:index + 8]))
+
+    lines += [
+        '    };',
+        '',
+        '    alignas(4) constexpr std::array<' + tile_type + ', ' + str(len(tile_set.tiles)) + '> tiles =',
+        '    {',
+    ]
+
+    for tile in tile_set.tiles:
+        # 4bpp tiles are written one index per pixel too and packed at compile time by the CharacterTile16 constructor
+        lines.append('        ' + tile_type + '{ std::array<Palette256Index, 64>{')
+        lines.append('            ' + format_tile(tile))
+        lines.append('        } },')
+
+    lines.append('    };')
+
+    if 'compression' in settings:
+        compressed = compressor.compress(tile_bytes(tile_set.tiles, bpp), settings['compression'])
+        lines += [
+            '',
+            '    alignas(4) constexpr std::array<u8, ' + str(len(compressed)) + '> compressedTiles =',
+            '    {',
+        ]
+
+        for index in range(0, len(compressed), 16):
+            lines.append('        ' + ' '.join(hex(value) + ',' for value in compressed[index:index + 16]))
+
+        lines.append('    };')
+
+    if emit_map:
+        lines += [
+            '',
+            '    constexpr Rectangle mapSizeTiles{ ' + str(tiles_size[0]) + ', ' + str(tiles_size[1]) + ' };',
+            '',
+            '    alignas(4) constexpr std::array<TextBackgroundTileDescription, ' + str(len(map_entries)) + '> map =',
+            '    {',
+        ]
+
+        for tile_number, horizontal, vertical in map_entries:
+            lines.append('        TextBackgroundTileDescription{ ' + str(tile_number) + ', ' + str(int(horizontal)) + ', ' +
+                         str(int(vertical)) + ', ' + str(palette_number if bpp == 4 else 0) + ' },')
+
+        lines.append('    };')
+
+    lines += ['}', '']
+
+    with open(header_path, 'w') as file:
+        file.write('\n'.join(lines))
+
+    return len(map_entries), len(tile_set.tiles)
+
+
+def process(graphics_path, build_path):
+    if not os.path.isdir(graphics_path):
+        return
+
+    os.makedirs(build_path, exist_ok=True)
+
+    for file_name in sorted(os.listdir(graphics_path)):
+        name, extension = os.path.splitext(file_name)
+        if extension.lower() != '.bmp':
+            continue
+
+        bmp_path = os.path.join(graphics_path, file_name)
+        json_path = os.path.join(graphics_path, name + '.json')
+        header_path = os.path.join(build_path, 'cgba_' + name + '.hpp')
+        inputs = [bmp_path, __file__] + ([json_path] if os.path.isfile(json_path) else [])
+
+        if os.path.isfile(header_path) and \
+                os.path.getmtime(header_path) >= max(os.path.getmtime(path) for path in inputs):
+            continue
+
+        settings = {}
+        if os.path.isfile(json_path):
+            with open(json_path) as file:
+                settings = json.load(file)
+
+        map_tiles, unique_tiles = write_header(name, Bitmap(bmp_path), settings, header_path)
+        print(file_name + ': ' + str(unique_tiles) + ' unique tiles from ' + str(map_tiles) + ' map tiles')
+
+
+if __name__ == '__main__':
+    project_path = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description='cgba tile converter')
+    parser.add_argument('--graphics', default='graphics/cgba', help='folder containing the indexed BMP files')
+    parser.add_argument('--build', default='build', help='folder where the generated headers are written')
+    args = parser.parse_args()
+
+    try:
+        process(os.path.join(project_path, args.graphics), os.path.join(project_path, args.build))
+    except ValueError as error:
+        sys.stderr.write('tile_converter error: ' + str(error) + '\n')
+        sys.exit(1)